@@ -0,0 +1,556 @@
+
+// headless benchmark. runs the game simulation for a fixed number of fixed size ticks without
+// opening a window or an audio device, and reports time per tick overall and per ruleset.
+//
+// usage: bench [--ticks N] [--bikes N] [--boxes N] [--dt seconds]
+
+#include <rynx/application/simulation.hpp>
+#include <rynx/application/logic.hpp>
+#include <rynx/application/components.hpp>
+#include <rynx/rulesets/motion.hpp>
+#include <rynx/rulesets/collisions.hpp>
+#include <rynx/rulesets/particles.hpp>
+#include <rynx/rulesets/lifetime.hpp>
+#include <rynx/rulesets/physics/springs.hpp>
+#include <rynx/graphics/camera/camera.hpp>
+#include <rynx/graphics/mesh/shape.hpp>
+#include <rynx/scheduler/task_scheduler.hpp>
+#include <rynx/tech/collision_detection.hpp>
+#include <rynx/tech/components.hpp>
+#include <rynx/tech/ecs.hpp>
+#include <rynx/tech/profiling.hpp>
+
+#include <game/bike_creation.hpp>
+#include <game/broadphase.hpp>
+#include <game/collision_categories.hpp>
+#include <game/editor_shapes.hpp>
+#include <game/entity_builder.hpp>
+#include <game/ecs_commands.hpp>
+#include <game/height_field_collisions.hpp>
+#include <game/segment_kernels.hpp>
+#include <game/spring_joints.hpp>
+#include <game/suspension_tracking.hpp>
+#include <game/terrain_profile.hpp>
+#include <game/terrain_sampler.hpp>
+#include <game/terrain_streaming.hpp>
+#include <game/transform_changes.hpp>
+#include <game/world_raycast.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+	using bench_clock = std::chrono::steady_clock;
+
+	double ms_since(bench_clock::time_point begin) {
+		return std::chrono::duration<double, std::milli>(bench_clock::now() - begin).count();
+	}
+
+	struct bench_options {
+		int32_t ticks = 2000;
+		int32_t bikes = 200;
+		int32_t boxes = 10000; // crates for the box pile pass, spawned the way the editor spawns them.
+		float dt = 1.0f / 120.0f;
+	};
+
+	bench_options parse_options(int argc, char** argv) {
+		bench_options options;
+		for (int i = 1; i + 1 < argc; i += 2) {
+			if (std::strcmp(argv[i], "--ticks") == 0) {
+				options.ticks = std::max(1, std::atoi(argv[i + 1]));
+			}
+			else if (std::strcmp(argv[i], "--bikes") == 0) {
+				options.bikes = std::max(0, std::atoi(argv[i + 1]));
+			}
+			else if (std::strcmp(argv[i], "--boxes") == 0) {
+				options.boxes = std::max(0, std::atoi(argv[i + 1]));
+			}
+			else if (std::strcmp(argv[i], "--dt") == 0) {
+				options.dt = std::max(0.0001f, float(std::atof(argv[i + 1])));
+			}
+			else {
+				std::fprintf(stderr, "unknown option: %s\n", argv[i]);
+			}
+		}
+		return options;
+	}
+
+	// the game simulation without anything that needs a window, gpu or audio device.
+	// when measuring rulesets one at a time, each ruleset gets its own state and runs in its own scheduler frame.
+	// batched_springs solves the joints with game::spring_joints instead of rynx::ruleset::physics::springs, which the game uses.
+	class bench_world {
+	public:
+		bench_world(const bench_options& options, bool per_ruleset, bool batched_springs = false)
+			: m_options(options)
+			, m_simulation(m_scheduler)
+			, m_per_ruleset(per_ruleset)
+		{
+			rynx::ecs& ecs = m_simulation.m_ecs;
+			m_simulation.set_resource(&m_detection);
+			m_simulation.set_resource(&m_commands);
+			m_simulation.set_resource(&m_camera);
+			m_simulation.set_resource(&m_changes);
+
+			game_collisions collisions(m_detection);
+			collisions.configure(m_broadphase);
+			m_solid_categories = { collisions.category_dynamic(), collisions.category_static(), collisions.category_terrain(), collisions.category_wheels() };
+
+			constexpr float bike_spacing = 80.0f;
+			constexpr float first_bike_x = -800.0f;
+
+			constexpr float box_spacing = 25.0f;
+			constexpr int32_t box_columns = 100;
+
+			game::terrain_streaming_config terrain_config;
+			const float world_width = std::max(options.bikes * bike_spacing, std::min(options.boxes, box_columns) * box_spacing);
+			terrain_config.chunks_ahead = static_cast<int32_t>(world_width / terrain_config.chunk_width) + 3;
+
+			auto collision_detection = add_ruleset<rynx::ruleset::physics_2d>("collision detection");
+			auto height_field_collisions = add_ruleset<game::height_field_collisions>("height field collisions");
+			auto motion_updates = add_ruleset<rynx::ruleset::motion_updates>("motion updates", rynx::vec3<float>(0, -160.8f, 0));
+			// suspension telemetry reads the joints after the solver has moved them, as in the game.
+			auto solve_joints_after_motion = [&](auto joint_solver) {
+				auto suspension_tracking = add_ruleset<game::suspension_tracking>("suspension tracking");
+				if (!per_ruleset) {
+					joint_solver->depends_on(motion_updates);
+					suspension_tracking->depends_on(joint_solver);
+				}
+			};
+
+			if (batched_springs) {
+				solve_joints_after_motion(add_ruleset<game::spring_joints>("spring joints"));
+			}
+			else {
+				solve_joints_after_motion(add_ruleset<rynx::ruleset::physics::springs>("engine springs"));
+			}
+
+			add_ruleset<rynx::ruleset::lifetime_updates>("lifetime updates");
+			add_ruleset<rynx::ruleset::particle_system>("particles");
+			add_ruleset<game::terrain_streaming>("terrain streaming", collisions.category_terrain(), terrain_config);
+
+			if (!per_ruleset) {
+				collision_detection->depends_on(motion_updates);
+				height_field_collisions->depends_on(collision_detection);
+			}
+
+			std::vector<rynx::vec3f> spawn_points;
+			for (int32_t i = 0; i < options.bikes; ++i) {
+				const float x = first_bike_x + i * bike_spacing;
+				spawn_points.emplace_back(x, game::terrain_height(x) + 60.0f, 0.0f);
+			}
+
+			game::bike_prefab(collisions.category_dynamic(), collisions.category_wheels(), nullptr).instantiate_each(ecs, spawn_points, m_bikes);
+
+			// crates stacked in loose columns above the terrain, the pile falls and settles into resting contact.
+			const rynx::polygon box_shape = rynx::Shape::makeBox(20.0f);
+			std::vector<rynx::ecs::id> boxes;
+			game::create_each(ecs, size_t(options.boxes), [&](size_t i) {
+				const int32_t column = int32_t(i) % box_columns;
+				const int32_t row = int32_t(i) / box_columns;
+				const float x = first_bike_x + column * box_spacing;
+				const rynx::vec3f pos(x, game::terrain_height(x) + 30.0f + row * box_spacing, 0.0f);
+				return game::dynamic_box(box_shape, pos, collisions.category_dynamic());
+			}, boxes);
+			
+			if (options.boxes > 0) {
+				m_camera.setPosition({ first_bike_x, 0, 750 });
+			}
+		}
+
+		void run() {
+			for (int32_t tick = 0; tick < m_options.ticks; ++tick) {
+				step();
+			}
+		}
+
+		void step() {
+			auto tick_begin = bench_clock::now();
+			drive();
+
+			if (m_per_ruleset) {
+				for (auto& stage : m_stages) {
+					for (auto& other : m_stages) {
+						other.state.disable();
+					}
+					stage.state.enable();
+
+					auto stage_begin = bench_clock::now();
+					run_frame();
+					stage.ms += ms_since(stage_begin);
+				}
+			}
+			else {
+				run_frame();
+			}
+
+			m_commands.apply(m_simulation.m_ecs, m_detection, m_simulation.m_logic, *m_simulation.m_context);
+
+			auto changes_begin = bench_clock::now();
+			m_changes.end_tick(m_simulation.m_ecs);
+			m_changes_ms += ms_since(changes_begin);
+			m_moved += m_changes.last_tick().size();
+			m_total_ms += ms_since(tick_begin);
+
+			// not part of the tick, nothing in the simulation reads the pairs.
+			auto broadphase_begin = bench_clock::now();
+			m_broadphase.update(m_simulation.m_ecs, m_changes);
+			m_broadphase_ms += ms_since(broadphase_begin);
+			m_broadphase_pairs += m_broadphase.pairs().size();
+		}
+
+		// position of every bike part, in bike order. parts that no longer exist are reported at the origin.
+		void bike_positions(std::vector<rynx::vec3f>& out) {
+			rynx::ecs& ecs = m_simulation.m_ecs;
+			out.clear();
+			for (const auto& bike : m_bikes) {
+				for (auto id : { bike.head, bike.back_wheel, bike.front_wheel, bike.bike_body }) {
+					out.emplace_back(ecs.exists(id) ? ecs[id].get<rynx::components::position>().value : rynx::vec3f());
+				}
+			}
+		}
+
+		double ms_per_tick(int32_t ticks) const { return m_total_ms / ticks; }
+
+		void report() const {
+			const double ticks = double(m_options.ticks);
+			if (m_per_ruleset) {
+				std::printf("per ruleset, one scheduler frame each:\n");
+				for (const auto& stage : m_stages) {
+					std::printf("  %-26s %8.4f ms/tick\n", stage.name.c_str(), stage.ms / ticks);
+				}
+				std::printf("  %-26s %8.4f ms/tick\n", "total", m_total_ms / ticks);
+			}
+			else {
+				std::printf("all rulesets, one scheduler frame: %.4f ms/tick\n", m_total_ms / ticks);
+			}
+			std::printf("transform changes: %.4f ms/tick, %.1f entities moved per tick\n", m_changes_ms / ticks, m_moved / ticks);
+			std::printf("game broadphase: %.4f ms/tick, %.1f pairs per tick, %zu moving, %zu fixed, %d static tree builds\n",
+				m_broadphase_ms / ticks, m_broadphase_pairs / ticks, m_broadphase.moving_count(), m_broadphase.fixed_count(), m_broadphase.static_rebuilds());
+		}
+
+		// pairs of the last broadphase update against testing every moving body with every collider.
+		// the crate pile enables every pair it has, dynamic with dynamic and dynamic with terrain.
+		void report_broadphase_check() {
+			struct body {
+				game::aabb bounds;
+				bool moving;
+			};
+
+			rynx::ecs& ecs = m_simulation.m_ecs;
+			std::vector<body> bodies;
+			ecs.query().for_each([&](const rynx::components::collisions&, const rynx::components::position& pos, const rynx::components::radius& radius, const rynx::components::motion&) {
+				const game::vec2 center(pos.value);
+				bodies.emplace_back(body{ { center - game::vec2(radius.r, radius.r), center + game::vec2(radius.r, radius.r) }, true });
+			});
+			ecs.query().notIn<rynx::components::motion>().for_each([&](const rynx::components::collisions&, const rynx::components::boundary& boundary) {
+				game::aabb bounds{ { std::numeric_limits<float>::max(), std::numeric_limits<float>::max() }, { std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() } };
+				for (int32_t i = 0; i < boundary.segments_world.size(); ++i) {
+					const auto s = boundary.segments_world.segment(i);
+					bounds = bounds.merged({ game::vec2(s.p1), game::vec2(s.p1) }).merged({ game::vec2(s.p2), game::vec2(s.p2) });
+				}
+				bodies.emplace_back(body{ bounds, false });
+			});
+
+			auto begin = bench_clock::now();
+			size_t expected = 0;
+			for (size_t i = 0; i < bodies.size(); ++i) {
+				for (size_t k = i + 1; k < bodies.size(); ++k) {
+					expected += (bodies[i].moving || bodies[k].moving) && bodies[i].bounds.overlaps(bodies[k].bounds);
+				}
+			}
+			const double brute_ms = ms_since(begin);
+
+			std::printf("  broadphase check: %zu pairs, all against all %zu pairs in %.1f ms\n", m_broadphase.pairs().size(), expected, brute_ms);
+		}
+
+		// hitscan shots fired from above the camera into the world as it is after the run, one batch per call.
+		void report_raycasts() {
+			constexpr int32_t num_rays = 1 << 14;
+			const rynx::vec3f center = m_camera.position();
+
+			std::vector<game::ray_query> queries(num_rays);
+			std::mt19937 random(4321);
+			std::uniform_real_distribution<float> spread(-1000.0f, 1000.0f);
+			for (auto& query : queries) {
+				query.from = rynx::vec3f(center.x + spread(random), center.y + 500.0f, 0.0f);
+				query.to = rynx::vec3f(center.x + spread(random), center.y - 500.0f, 0.0f);
+			}
+
+			auto build_begin = bench_clock::now();
+			game::world_raycast world;
+			world.build(m_simulation.m_ecs, m_solid_categories);
+			const double build_ms = ms_since(build_begin);
+
+			std::vector<game::ray_hit> hits(num_rays);
+			auto cast_begin = bench_clock::now();
+			world.cast(queries.data(), num_rays, hits.data());
+			const double cast_ms = ms_since(cast_begin);
+
+			const auto num_hits = std::count_if(hits.begin(), hits.end(), [](const game::ray_hit& hit) { return hit.hit; });
+			std::printf("world raycast: build %.3f ms, %d rays %.3f ms (%.1f ns/ray), %d hits\n",
+				build_ms, num_rays, cast_ms, cast_ms * 1e6 / num_rays, int32_t(num_hits));
+		}
+
+	private:
+		struct stage {
+			std::string name;
+			rynx::binary_config::id state;
+			double ms = 0.0;
+		};
+
+		template<typename T, typename... Args>
+		auto add_ruleset(std::string name, Args&&... args) {
+			auto state = m_simulation.m_context->access_state().generate_state_id();
+			m_stages.emplace_back(stage{ std::move(name), state, 0.0 });
+			return m_simulation.rule_set(state).template create<T>(std::forward<Args>(args)...);
+		}
+
+		// full throttle on every bike, and terrain follows the last bike.
+		void drive() {
+			constexpr float max_speed = 75;
+			constexpr float max_acceleration = 700;
+
+			rynx::ecs& ecs = m_simulation.m_ecs;
+			float last_x = std::numeric_limits<float>::max();
+			for (const auto& bike : m_bikes) {
+				if (ecs.exists(bike.back_wheel)) {
+					auto& mot = ecs[bike.back_wheel].get<rynx::components::motion>();
+					mot.angularAcceleration = -max_acceleration * (max_speed + mot.angularVelocity) / max_speed;
+				}
+				if (ecs.exists(bike.bike_body)) {
+					last_x = std::min(last_x, ecs[bike.bike_body].get<rynx::components::position>().value.x);
+				}
+			}
+
+			if (last_x != std::numeric_limits<float>::max()) {
+				m_camera.setPosition({ last_x, 0, 750 });
+			}
+		}
+
+		void run_frame() {
+			m_simulation.generate_tasks(m_options.dt);
+			m_scheduler.start_frame();
+			m_scheduler.wait_until_complete();
+		}
+
+		bench_options m_options;
+		rynx::scheduler::task_scheduler m_scheduler;
+		rynx::application::simulation m_simulation;
+		rynx::collision_detection m_detection;
+		rynx::camera m_camera;
+		game::transform_changes m_changes;
+		game::broadphase m_broadphase;
+		std::vector<rynx::collision_detection::category_id> m_solid_categories;
+		std::vector<game::bike_instance> m_bikes;
+		std::vector<stage> m_stages;
+		double m_total_ms = 0.0;
+		double m_changes_ms = 0.0;
+		double m_moved = 0.0;
+		double m_broadphase_ms = 0.0;
+		double m_broadphase_pairs = 0.0;
+		bool m_per_ruleset;
+	};
+
+	// the same bikes driven with the engine joint solver and with game::spring_joints, side by side.
+	// reports how far apart the bike parts end up, next to the gap between two runs with the same solver,
+	// which is what scheduling order alone does to the simulation.
+	void compare_joint_solvers(const bench_options& options) {
+		bench_options compare_options = options;
+		compare_options.bikes = std::min(options.bikes, 20);
+		compare_options.boxes = 0;
+		if (compare_options.bikes == 0) {
+			return;
+		}
+
+		// one world at a time, like the other passes. bike part positions of every tick are kept for comparing afterwards.
+		struct trajectory {
+			std::vector<rynx::vec3f> positions;
+			double ms_per_tick = 0.0;
+		};
+
+		auto record = [&](bool batched_springs) {
+			trajectory result;
+			bench_world world(compare_options, false, batched_springs);
+			std::vector<rynx::vec3f> tick_positions;
+			for (int32_t tick = 0; tick < compare_options.ticks; ++tick) {
+				world.step();
+				world.bike_positions(tick_positions);
+				result.positions.insert(result.positions.end(), tick_positions.begin(), tick_positions.end());
+			}
+			result.ms_per_tick = world.ms_per_tick(compare_options.ticks);
+			return result;
+		};
+
+		struct divergence {
+			double mean = 0.0;
+			float max = 0.0f;
+		};
+
+		auto measure = [](const trajectory& a, const trajectory& b) {
+			divergence d;
+			for (size_t i = 0; i < a.positions.size(); ++i) {
+				const float distance = (a.positions[i] - b.positions[i]).length();
+				d.mean += distance;
+				d.max = std::max(d.max, distance);
+			}
+			d.mean /= double(std::max<size_t>(1, a.positions.size()));
+			return d;
+		};
+
+		const trajectory engine = record(false);
+		const trajectory batched = record(true);
+		const trajectory batched_again = record(true);
+		const divergence solvers = measure(engine, batched);
+		const divergence runs = measure(batched, batched_again);
+
+		std::printf("joint solvers, %d bikes: engine springs %.4f ms/tick, spring joints %.4f ms/tick\n",
+			compare_options.bikes, engine.ms_per_tick, batched.ms_per_tick);
+		std::printf("  bike part distance, engine vs spring joints: mean %.3f max %.3f\n", solvers.mean, double(solvers.max));
+		std::printf("  bike part distance, spring joints run to run: mean %.3f max %.3f\n", runs.mean, double(runs.max));
+	}
+
+	// batched terrain sampling against evaluating game::terrain_height and game::terrain_slope one x at a time.
+	void bench_terrain_sampler() {
+		constexpr int32_t count = 1 << 16;
+		constexpr int32_t rounds = 64;
+		std::vector<float> heights(count);
+		std::vector<float> slopes(count);
+
+		float checksum = 0.0f;
+		auto batched_begin = bench_clock::now();
+		for (int32_t round = 0; round < rounds; ++round) {
+			game::sample_terrain(round * 10.0f, 10.0f, heights.data(), slopes.data(), count);
+			checksum += heights[round] + slopes[round];
+		}
+		const double batched_ms = ms_since(batched_begin);
+
+		auto scalar_begin = bench_clock::now();
+		for (int32_t round = 0; round < rounds; ++round) {
+			for (int32_t i = 0; i < count; ++i) {
+				const float x = round * 10.0f + i * 10.0f;
+				heights[i] = game::terrain_height(x);
+				slopes[i] = game::terrain_slope(x);
+			}
+			checksum += heights[round] + slopes[round];
+		}
+		const double scalar_ms = ms_since(scalar_begin);
+
+		const double samples = double(count) * rounds;
+		std::printf("terrain sampler: batched %.2f ns/sample, scalar %.2f ns/sample (checksum %g)\n",
+			batched_ms * 1e6 / samples,
+			scalar_ms * 1e6 / samples,
+			double(checksum));
+	}
+
+	// one circle against every segment of a terrain sized boundary, the way the polygon narrow phase sees it.
+	// every fourth query has zero radius, which is the polygon vertex against edge case.
+	void bench_segment_kernels() {
+		constexpr int32_t num_samples = 600;
+		constexpr float x_begin = -1000.0f;
+		constexpr float spacing = 10.0f;
+		constexpr int32_t num_segments = num_samples - 1;
+		constexpr int32_t num_queries = 1 << 15;
+		constexpr int32_t rounds = 8;
+
+		std::vector<float> heights(num_samples);
+		std::vector<float> slopes(num_samples);
+		game::sample_terrain(x_begin, spacing, heights.data(), slopes.data(), num_samples);
+
+		std::vector<float> ax(num_segments), ay(num_segments), bx(num_segments), by(num_segments);
+		for (int32_t i = 0; i < num_segments; ++i) {
+			ax[i] = x_begin + i * spacing;
+			ay[i] = heights[i];
+			bx[i] = ax[i] + spacing;
+			by[i] = heights[i + 1];
+		}
+
+		struct query { float x, y, r; };
+		std::vector<query> queries(num_queries);
+		std::mt19937 random(1234);
+		std::uniform_int_distribution<int32_t> sample(0, num_samples - 1);
+		std::uniform_real_distribution<float> offset(-20.0f, 20.0f);
+		for (int32_t i = 0; i < num_queries; ++i) {
+			const int32_t k = sample(random);
+			queries[i] = { x_begin + k * spacing + offset(random), heights[k] + offset(random), (i % 4 == 0) ? 0.0f : 12.0f };
+		}
+
+		std::vector<game::segment_contact> contacts(num_segments);
+		auto run = [&](auto&& kernel) {
+			float checksum = 0.0f;
+			for (int32_t round = 0; round < rounds; ++round) {
+				for (const auto& q : queries) {
+					const int32_t hits = kernel(ax.data(), ay.data(), bx.data(), by.data(), num_segments, q.x, q.y, q.r, contacts.data());
+					for (int32_t h = 0; h < hits; ++h) {
+						checksum += contacts[h].depth;
+					}
+				}
+			}
+			return checksum;
+		};
+
+		auto simd_begin = bench_clock::now();
+		const float simd_checksum = run(game::circle_vs_segments);
+		const double simd_ms = ms_since(simd_begin);
+
+		auto scalar_begin = bench_clock::now();
+		const float scalar_checksum = run(game::circle_vs_segments_scalar);
+		const double scalar_ms = ms_since(scalar_begin);
+
+		const double tests = double(num_queries) * rounds;
+		std::printf("circle vs %d segments: simd %.2f ns/test, scalar %.2f ns/test (checksum %g / %g)\n",
+			num_segments,
+			simd_ms * 1e6 / tests,
+			scalar_ms * 1e6 / tests,
+			double(simd_checksum),
+			double(scalar_checksum));
+	}
+}
+
+int main(int argc, char** argv) {
+	rynx::this_thread::rynx_thread_raii rynx_thread_services_required_token;
+	const bench_options options = parse_options(argc, argv);
+
+	std::printf("bikes: %d, ticks: %d, dt: %.3f ms\n", options.bikes, options.ticks, options.dt * 1000.0f);
+
+	bench_options bike_options = options;
+	bike_options.boxes = 0;
+
+	{
+		bench_world world(bike_options, false);
+		world.run();
+		world.report();
+		world.report_raycasts();
+	}
+
+	{
+		bench_world world(bike_options, true);
+		world.run();
+		world.report();
+	}
+
+	compare_joint_solvers(bike_options);
+
+	// broadphase load: a pile of dynamic crates and nothing else.
+	if (options.boxes > 0) {
+		bench_options box_options = options;
+		box_options.bikes = 0;
+
+		std::printf("box pile, boxes: %d\n", box_options.boxes);
+		bench_world world(box_options, true);
+		world.run();
+		world.report();
+		world.report_broadphase_check();
+	}
+
+	bench_terrain_sampler();
+	bench_segment_kernels();
+	return 0;
+}
@@ -0,0 +1,209 @@
+
+#include <game/bike_creation.hpp>
+#include <game/components.hpp>
+#include <game/height_field.hpp>
+
+#include <rynx/graphics/mesh/shape.hpp>
+#include <rynx/tech/profiling.hpp>
+
+game::bike_prefab::bike_prefab(
+	rynx::collision_detection::category_id dynamicCollisions,
+	rynx::collision_detection::category_id wheelCollisions,
+	rynx::graphics::mesh_collection* meshes)
+	: m_dynamic_collisions(dynamicCollisions)
+	, m_wheel_collisions(wheelCollisions)
+{
+	auto poly = rynx::Shape::makeBox(15.0f);
+	
+	m_radius = poly.radius();
+
+	float wheel_radius_scale = 1.3f;
+	float head_radius_scale = 1.0f;
+
+	m_head_shape = rynx::polygon(poly).scale(head_radius_scale).recompute_normals();
+	m_head_radius = m_radius * head_radius_scale;
+	m_wheel_radius = m_radius * wheel_radius_scale;
+	m_bike_body_radius = m_radius * 3.3f;
+
+	m_offsets[part_head] = rynx::vec3f(0, 0, 0);
+	m_offsets[part_back_wheel] = rynx::vec3f(-22, -40, 0);
+	m_offsets[part_front_wheel] = rynx::vec3f(+27, -40, 0);
+	m_offsets[part_bike_body] = rynx::vec3f(+0, -25, 0);
+
+	auto wheel_shape = rynx::Shape::makeCircle(m_wheel_radius, 50);
+	m_head_body = rynx::components::physical_body().mass(150).elasticity(0.0f).friction(1.0f).moment_of_inertia(poly);
+	m_back_wheel_body = rynx::components::physical_body().mass(50).elasticity(0.0f).friction(30.0f).moment_of_inertia(wheel_shape);
+	m_front_wheel_body = rynx::components::physical_body().mass(50).elasticity(0.0f).friction(10.0f).moment_of_inertia(wheel_shape);
+	m_bike_body_body = rynx::components::physical_body().mass(650).elasticity(0.0f).friction(1.0f).moment_of_inertia(poly);
+
+#ifndef GAME_HEADLESS
+	if (meshes) {
+		m_head_mesh = meshes->get("head");
+		m_wheel_mesh = meshes->get("wheel");
+		m_bike_body_mesh = meshes->get("bike_body");
+	}
+#endif
+
+	m_head_light.ambient = 0.3f;
+	m_head_light.attenuation_linear = 1.5f;
+	m_head_light.attenuation_quadratic = 0.005f;
+	m_head_light.color = { 1.0f, 1.0f, 1.0f, 5.0f };
+
+	m_bike_light.ambient = 0;
+	m_bike_light.angle = 1.55f;
+	m_bike_light.attenuation_linear = 1.5f;
+	m_bike_light.attenuation_quadratic = 0.001f;
+	m_bike_light.direction = { 1.0f, 0.0f, 0.0f };
+	m_bike_light.edge_softness = 0.3f;
+	m_bike_light.color = { 1.0f, 0.6f, 0.2f, 50.0f };
+
+	m_exhaust.constant_force = { {0, 5, 0}, {0, 10, 0} };
+	m_exhaust.end_radius = { 0.0f, 0.0f };
+	m_exhaust.start_radius = { 5.0f, 8.0f };
+	m_exhaust.initial_angle = { rynx::math::pi - 0.45f, rynx::math::pi + 0.45f };
+	m_exhaust.initial_velocity = { 40.0f, 80.0f };
+	m_exhaust.linear_dampening = { 0.2f, 0.6f };
+	m_exhaust.position_offset = { -30.0f, 0.0f, 0.0f };
+	m_exhaust.lifetime_range = { 0.2f, 0.6f };
+	m_exhaust.rotate_with_host = true;
+	m_exhaust.spawn_rate = { 10.0f, 20.0f };
+	m_exhaust.start_color = { {0.2f, 0.2f, 0.2f, 0.5f}, {0.4f, 0.4f, 0.4f, 0.5f} };
+	m_exhaust.end_color = { {0.8f, 0.8f, 0.8f, 0.0f}, {0.9f, 0.9f, 0.9f, 0.0f} };
+	m_exhaust.time_until_next_spawn = 0.0f;
+
+	constexpr float fix_velocity = 0.55f;
+	constexpr float frontback_joints_strength = 0.04f;
+	constexpr float bike_joints_strength = 0.1005f;
+	constexpr float front_wheel_joint_mul = 0.75f;
+
+	add_joint(part_back_wheel, part_bike_body, frontback_joints_strength, 3.0f, fix_velocity, { -45, +13, 0 }, {}, true);
+	add_joint(part_back_wheel, part_bike_body, frontback_joints_strength, 3.0f, fix_velocity, { +15, -25, 0 }, {}, true);
+
+	add_joint(part_front_wheel, part_bike_body, frontback_joints_strength * front_wheel_joint_mul, 3.0f, fix_velocity, { +52, +15, 0 }, {}, true);
+	add_joint(part_front_wheel, part_bike_body, frontback_joints_strength * front_wheel_joint_mul, 3.0f, fix_velocity, { -15, -25, 0 }, {}, true);
+
+	add_joint(part_back_wheel, part_bike_body, bike_joints_strength, 3.0f, fix_velocity, { +19, +27, 0 }, {}, true);
+	add_joint(part_front_wheel, part_bike_body, bike_joints_strength * front_wheel_joint_mul, 3.0f, fix_velocity, { -10, +27, 0 }, {}, true);
+
+	// connect rider to bike body or something.
+	add_joint(part_head, part_bike_body, 0.9f, 3.0f, +0.056f, { -5, 0, 0 }, { -5, 0, 0 }, false);
+	add_joint(part_head, part_bike_body, 0.9f, 1.0f, +0.056f, { +5, 0, 0 }, { +5, 0, 0 }, false);
+	add_joint(part_head, part_bike_body, 0.9f, 3.0f, +0.056f, { 0, 0, 0 }, { 0, 0, 0 }, false);
+	
+	m_hand_joint_index = static_cast<int32_t>(m_joints.size());
+	add_joint(part_head, part_bike_body, 1.2f, 2.0f, +0.016f, { +22, +10, 0 }, { +5, 0, 0 }, false); // hand to steering.
+}
+
+void game::bike_prefab::add_joint(int32_t part_a, int32_t part_b, float strength, float softness, float response_time, rynx::vec3f point_b, rynx::vec3f point_a, bool suspension) {
+	joint_template& t = m_joints.emplace_back();
+	t.part_a = part_a;
+	t.part_b = part_b;
+	t.suspension = suspension;
+	
+	t.joint.connect_with_spring().rotation_free();
+	t.joint.point_a = point_a;
+	t.joint.point_b = point_b;
+	t.joint.strength = strength;
+	t.joint.softness = softness;
+	t.joint.response_time = response_time;
+
+	// every part spawns with zero rotation, so rest length only depends on the layout.
+	t.joint.length = ((m_offsets[part_a] + point_a) - (m_offsets[part_b] + point_b)).length();
+}
+
+game::bike_instance game::bike_prefab::instantiate(rynx::ecs& ecs, rynx::vec3f pos) const {
+	constexpr float angle = 0.0f;
+	bike_instance bike;
+
+	const rynx::vec3f head_pos = pos + m_offsets[part_head];
+	bike.head = ecs.create(
+		m_head_light,
+		rynx::components::position(head_pos, angle),
+		rynx::components::collisions{ m_dynamic_collisions.value },
+		rynx::components::boundary(m_head_shape, head_pos, angle),
+		rynx::components::mesh(m_head_mesh),
+		rynx::matrix4(),
+		rynx::components::radius(m_head_radius),
+		rynx::components::color({ 1.0f, 1.0f, 1.0f, 1.0f }),
+		rynx::components::motion({ 0, 0, 0 }, 0),
+		rynx::components::physical_body(m_head_body),
+		rynx::components::dampening{ 0.05f, 0.05f },
+		rynx::components::collision_custom_reaction{}
+	);
+
+	bike.back_wheel = ecs.create(
+		rynx::components::position(pos + m_offsets[part_back_wheel], angle),
+		rynx::components::collisions{ m_wheel_collisions.value },
+		game::components::height_field_body(),
+		rynx::components::mesh(m_wheel_mesh),
+		rynx::matrix4(),
+		rynx::components::radius(m_wheel_radius),
+		rynx::components::color({ 1.0f, 1.0f, 1.0f, 1.0f }),
+		rynx::components::motion({ 0, 0, 0 }, -10),
+		rynx::components::physical_body(m_back_wheel_body),
+		rynx::components::dampening{ 0.05f, 0.05f },
+		rynx::components::collision_custom_reaction()
+	);
+
+	bike.front_wheel = ecs.create(
+		rynx::components::position(pos + m_offsets[part_front_wheel], angle),
+		rynx::components::collisions{ m_wheel_collisions.value },
+		game::components::height_field_body(),
+		rynx::components::mesh(m_wheel_mesh),
+		rynx::matrix4(),
+		rynx::components::radius(m_wheel_radius),
+		rynx::components::color({ 1.0f, 1.0f, 1.0f, 1.0f }),
+		rynx::components::motion({ 0, 0, 0 }, 0),
+		rynx::components::physical_body(m_front_wheel_body),
+		rynx::components::dampening{ 0.05f, 0.05f },
+		rynx::components::collision_custom_reaction()
+	);
+
+	bike.bike_body = ecs.create(
+		m_bike_light,
+		m_exhaust,
+		game::components::suspension_state(),
+		rynx::components::position(pos + m_offsets[part_bike_body], angle),
+		rynx::components::mesh(m_bike_body_mesh),
+		rynx::matrix4(),
+		rynx::components::radius(m_bike_body_radius),
+		rynx::components::color({ 1.0f, 1.0f, 1.0f, 1.0f }),
+		rynx::components::motion({ 0, 0, 0 }, 0),
+		rynx::components::physical_body(m_bike_body_body),
+		rynx::components::dampening{ 0.05f, 0.05f }
+	);
+
+	auto part_id = [&bike](int32_t part) {
+		switch (part) {
+			case part_head: return bike.head;
+			case part_back_wheel: return bike.back_wheel;
+			case part_front_wheel: return bike.front_wheel;
+			default: return bike.bike_body;
+		}
+	};
+
+	for (size_t k = 0; k < m_joints.size(); ++k) {
+		const auto& t = m_joints[k];
+		rynx::components::phys::joint joint = t.joint;
+		joint.id_a = part_id(t.part_a);
+		joint.id_b = part_id(t.part_b);
+
+		rynx::ecs::id joint_id = t.suspension ?
+			ecs.create(joint, rynx::components::invisible(), game::components::suspension()) :
+			ecs.create(joint, rynx::components::invisible());
+
+		if (int32_t(k) == m_hand_joint_index) {
+			bike.hand_joint = joint_id;
+		}
+	}
+
+	return bike;
+}
+
+void game::bike_prefab::instantiate_each(rynx::ecs& ecs, const std::vector<rynx::vec3f>& positions, std::vector<bike_instance>& out) const {
+	rynx_profile("Game", "instantiate bikes");
+	out.reserve(out.size() + positions.size());
+	for (const auto& pos : positions) {
+		out.emplace_back(instantiate(ecs, pos));
+	}
+}
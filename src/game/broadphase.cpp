@@ -0,0 +1,259 @@
+#include <game/broadphase.hpp>
+
+#include <rynx/tech/components.hpp>
+#include <rynx/tech/profiling.hpp>
+
+#include <algorithm>
+
+void game::broadphase::add_moving_category(rynx::collision_detection::category_id category) {
+	if (category.value < max_categories) {
+		m_moving_categories |= uint64_t(1) << category.value;
+	}
+}
+
+void game::broadphase::add_fixed_category(rynx::collision_detection::category_id category) {
+	if (category.value < max_categories) {
+		m_fixed_categories |= uint64_t(1) << category.value;
+		m_tree_built = false;
+	}
+}
+
+void game::broadphase::enable_pair(rynx::collision_detection::category_id a, rynx::collision_detection::category_id b) {
+	if (a.value < max_categories && b.value < max_categories) {
+		m_enabled[a.value] |= uint64_t(1) << b.value;
+		m_enabled[b.value] |= uint64_t(1) << a.value;
+	}
+}
+
+void game::broadphase::update(rynx::ecs& ecs, const game::transform_changes& changes) {
+	rynx_profile("Game", "broadphase");
+	if (fixed_changed(ecs, changes)) {
+		build_tree(ecs);
+	}
+	m_tree_tick = changes.tick();
+
+	update_moving(ecs);
+	find_pairs();
+}
+
+// only marked entities are looked at. moving bodies are never marked, so this costs nothing while nothing is edited.
+bool game::broadphase::fixed_changed(rynx::ecs& ecs, const game::transform_changes& changes) const {
+	if (!m_tree_built) {
+		return true;
+	}
+
+	bool changed = false;
+	const bool complete = changes.for_each_marked_since(m_tree_tick, [&](rynx::ecs::id id) {
+		if (changed || m_fixed_ids.contains(id.value)) {
+			changed = true;
+			return;
+		}
+
+		// created, or moved into a fixed category.
+		if (ecs.exists(id)) {
+			auto entity = ecs[id];
+			const auto* collisions = entity.try_get<const rynx::components::collisions>();
+			changed = collisions && is_fixed(static_cast<uint32_t>(collisions->category)) && !entity.has<rynx::components::motion>();
+		}
+	});
+	return changed || !complete;
+}
+
+void game::broadphase::build_tree(rynx::ecs& ecs) {
+	rynx_profile("Game", "broadphase static tree");
+	m_fixed.clear();
+	m_fixed_ids.clear();
+	m_tree.clear();
+
+	ecs.query().notIn<rynx::components::motion>().for_each([this](rynx::ecs::id id, const rynx::components::collisions& collisions, const rynx::components::boundary& boundary) {
+		const uint32_t category = static_cast<uint32_t>(collisions.category);
+		if (!is_fixed(category) || boundary.segments_world.size() == 0) {
+			return;
+		}
+
+		const auto first = boundary.segments_world.segment(0);
+		aabb bounds{ game::vec2(first.p1), game::vec2(first.p1) };
+		for (int32_t i = 0; i < boundary.segments_world.size(); ++i) {
+			const auto s = boundary.segments_world.segment(i);
+			const game::vec2 p1(s.p1);
+			const game::vec2 p2(s.p2);
+			bounds = bounds.merged({ p1, p1 }).merged({ p2, p2 });
+		}
+		m_fixed.emplace_back(fixed_proxy{ bounds, id.value, category });
+	});
+
+	ecs.query().notIn<rynx::components::motion, rynx::components::boundary>().for_each([this](rynx::ecs::id id, const rynx::components::collisions& collisions, const rynx::components::position& pos, const rynx::components::radius& radius) {
+		const uint32_t category = static_cast<uint32_t>(collisions.category);
+		if (is_fixed(category)) {
+			const game::vec2 center(pos.value);
+			const game::vec2 extent(radius.r, radius.r);
+			m_fixed.emplace_back(fixed_proxy{ { center - extent, center + extent }, id.value, category });
+		}
+	});
+
+	for (const auto& proxy : m_fixed) {
+		m_fixed_ids.insert(proxy.id);
+	}
+
+	if (!m_fixed.empty()) {
+		m_tree.reserve(2 * (m_fixed.size() / leaf_size + 1));
+		m_tree.emplace_back();
+		build_node(0, 0, static_cast<int32_t>(m_fixed.size()));
+	}
+
+	m_tree_built = true;
+	++m_static_rebuilds;
+}
+
+// median split along the longer side. children of a node are stored next to each other.
+void game::broadphase::build_node(int32_t node, int32_t begin, int32_t end) {
+	aabb bounds = m_fixed[begin].bounds;
+	for (int32_t i = begin + 1; i < end; ++i) {
+		bounds = bounds.merged(m_fixed[i].bounds);
+	}
+
+	if (end - begin <= leaf_size) {
+		m_tree[node] = tree_node{ bounds, begin, end - begin };
+		return;
+	}
+
+	const game::vec2 extent = bounds.max - bounds.min;
+	const bool split_x = extent.x >= extent.y;
+	const int32_t middle = begin + (end - begin) / 2;
+	std::nth_element(m_fixed.begin() + begin, m_fixed.begin() + middle, m_fixed.begin() + end, [split_x](const fixed_proxy& a, const fixed_proxy& b) {
+		return split_x ?
+			a.bounds.min.x + a.bounds.max.x < b.bounds.min.x + b.bounds.max.x :
+			a.bounds.min.y + a.bounds.max.y < b.bounds.min.y + b.bounds.max.y;
+	});
+
+	const int32_t children = static_cast<int32_t>(m_tree.size());
+	m_tree.emplace_back();
+	m_tree.emplace_back();
+	m_tree[node] = tree_node{ bounds, children, 0 };
+	build_node(children, begin, middle);
+	build_node(children + 1, middle, end);
+}
+
+void game::broadphase::update_moving(rynx::ecs& ecs) {
+	++m_stamp;
+	size_t num_seen = 0;
+	size_t num_created = 0;
+
+	ecs.query().for_each([&](rynx::ecs::id id, const rynx::components::collisions& collisions, const rynx::components::position& pos, const rynx::components::radius& radius, const rynx::components::motion&) {
+		const uint32_t category = static_cast<uint32_t>(collisions.category);
+		if (!is_moving(category)) {
+			return;
+		}
+
+		auto [it, inserted] = m_moving_slot.try_emplace(id.value, static_cast<int32_t>(m_moving.size()));
+		if (inserted) {
+			m_moving.emplace_back();
+			m_sweep.emplace_back(sweep_entry{ {}, id.value, it->second, category });
+			++num_created;
+		}
+
+		const game::vec2 center(pos.value);
+		const game::vec2 extent(radius.r, radius.r);
+		m_moving[it->second] = moving_proxy{ { center - extent, center + extent }, id.value, category, m_stamp };
+		++num_seen;
+	});
+
+	// erased, or no longer in a moving category. proxies are compacted and the sweep order is kept.
+	if (num_seen != m_moving.size()) {
+		std::vector<int32_t> remap(m_moving.size(), -1);
+		int32_t kept = 0;
+		for (size_t i = 0; i < m_moving.size(); ++i) {
+			if (m_moving[i].seen == m_stamp) {
+				remap[i] = kept;
+				m_moving[kept++] = m_moving[i];
+			}
+			else {
+				m_moving_slot.erase(m_moving[i].id);
+			}
+		}
+		m_moving.resize(kept);
+
+		for (auto& entry : m_moving_slot) {
+			entry.second = remap[entry.second];
+		}
+
+		std::erase_if(m_sweep, [&remap](const sweep_entry& entry) { return remap[entry.proxy] < 0; });
+		for (auto& entry : m_sweep) {
+			entry.proxy = remap[entry.proxy];
+		}
+	}
+
+	for (auto& entry : m_sweep) {
+		const auto& proxy = m_moving[entry.proxy];
+		entry.bounds = proxy.bounds;
+		entry.category = proxy.category;
+	}
+
+	auto by_min_x = [](const sweep_entry& a, const sweep_entry& b) { return a.bounds.min.x < b.bounds.min.x; };
+
+	// bodies move little between ticks, so the order of the last tick is nearly right and insertion sort only
+	// moves the few that passed each other. a large batch of new bodies is appended in creation order, sort it properly.
+	if (num_created * 8 > m_sweep.size()) {
+		std::sort(m_sweep.begin(), m_sweep.end(), by_min_x);
+		return;
+	}
+
+	for (size_t i = 1; i < m_sweep.size(); ++i) {
+		if (!by_min_x(m_sweep[i], m_sweep[i - 1])) {
+			continue;
+		}
+
+		const sweep_entry entry = m_sweep[i];
+		size_t k = i;
+		do {
+			m_sweep[k] = m_sweep[k - 1];
+			--k;
+		} while (k > 0 && by_min_x(entry, m_sweep[k - 1]));
+		m_sweep[k] = entry;
+	}
+}
+
+void game::broadphase::find_pairs() {
+	m_pairs.clear();
+	const bool has_tree = !m_tree.empty();
+
+	for (size_t i = 0; i < m_sweep.size(); ++i) {
+		const auto& a = m_sweep[i];
+		const uint64_t enabled = mask(a.category);
+
+		if (enabled & m_moving_categories) {
+			for (size_t k = i + 1; k < m_sweep.size() && m_sweep[k].bounds.min.x <= a.bounds.max.x; ++k) {
+				const auto& b = m_sweep[k];
+				if (((enabled >> b.category) & 1) && a.bounds.min.y <= b.bounds.max.y && b.bounds.min.y <= a.bounds.max.y) {
+					m_pairs.emplace_back(pair{ a.id, b.id });
+				}
+			}
+		}
+
+		if (has_tree && (enabled & m_fixed_categories)) {
+			// the tree is a few levels deep, a fixed stack is plenty.
+			std::array<int32_t, 64> stack;
+			int32_t top = 0;
+			stack[top++] = 0;
+			while (top > 0) {
+				const auto& node = m_tree[stack[--top]];
+				if (!node.bounds.overlaps(a.bounds)) {
+					continue;
+				}
+
+				if (node.count == 0) {
+					stack[top++] = node.first;
+					stack[top++] = node.first + 1;
+					continue;
+				}
+
+				for (int32_t k = node.first; k < node.first + node.count; ++k) {
+					const auto& b = m_fixed[k];
+					if (((enabled >> b.category) & 1) && b.bounds.overlaps(a.bounds)) {
+						m_pairs.emplace_back(pair{ a.id, b.id });
+					}
+				}
+			}
+		}
+	}
+}
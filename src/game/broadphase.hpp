@@ -0,0 +1,121 @@
+#pragma once
+
+#include <game/transform2d.hpp>
+#include <game/transform_changes.hpp>
+
+#include <rynx/tech/collision_detection.hpp>
+#include <rynx/tech/ecs.hpp>
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace game {
+	struct aabb {
+		game::vec2 min;
+		game::vec2 max;
+
+		constexpr bool overlaps(const aabb& o) const {
+			return min.x <= o.max.x && o.min.x <= max.x && min.y <= o.max.y && o.min.y <= max.y;
+		}
+
+		constexpr aabb merged(const aabb& o) const {
+			return {
+				{ min.x < o.min.x ? min.x : o.min.x, min.y < o.min.y ? min.y : o.min.y },
+				{ max.x > o.max.x ? max.x : o.max.x, max.y > o.max.y ? max.y : o.max.y } };
+		}
+	};
+
+	// candidate collision pairs, split by how the two sides move.
+	// fixed categories (level pieces, editor polygons, terrain) hardly ever change. their bounds go into a tree that is
+	// built once and rebuilt only when game::transform_changes reports that one of them was marked: moved, edited,
+	// created or erased. moving categories change every tick. they are kept in a list sorted along x, which is
+	// already almost sorted from the tick before, so an insertion sort puts it back in order in close to linear time
+	// and a sweep over it finds the overlapping pairs. moving bodies are bounded by position and radius, fixed ones
+	// by their world space boundary when they have one.
+	//
+	// moving entities must have a motion component and fixed ones must not, entities the other way around are skipped.
+	class broadphase {
+	public:
+		struct pair {
+			rynx::ecs::id a; // always moving.
+			rynx::ecs::id b; // moving or fixed.
+		};
+
+		void add_moving_category(rynx::collision_detection::category_id category);
+		void add_fixed_category(rynx::collision_detection::category_id category);
+
+		// pairs are reported only between categories that are enabled with each other. order does not matter.
+		void enable_pair(rynx::collision_detection::category_id a, rynx::collision_detection::category_id b);
+
+		// once per logic tick, after transform_changes::end_tick.
+		void update(rynx::ecs& ecs, const game::transform_changes& changes);
+
+		const std::vector<pair>& pairs() const { return m_pairs; }
+		int32_t static_rebuilds() const { return m_static_rebuilds; }
+		size_t moving_count() const { return m_moving.size(); }
+		size_t fixed_count() const { return m_fixed.size(); }
+
+	private:
+		static constexpr int32_t max_categories = 64;
+		static constexpr int32_t leaf_size = 4;
+
+		struct fixed_proxy {
+			aabb bounds;
+			uint64_t id;
+			uint32_t category;
+		};
+
+		// inner nodes have count == 0 and their children at first and first + 1.
+		struct tree_node {
+			aabb bounds;
+			int32_t first = 0;
+			int32_t count = 0;
+		};
+
+		struct moving_proxy {
+			aabb bounds;
+			uint64_t id;
+			uint32_t category;
+			uint32_t seen;
+		};
+
+		// sweep order. bounds are copied in each tick, so the sweep reads one contiguous array.
+		struct sweep_entry {
+			aabb bounds;
+			uint64_t id;
+			int32_t proxy;
+			uint32_t category;
+		};
+
+		bool fixed_changed(rynx::ecs& ecs, const game::transform_changes& changes) const;
+		bool is_fixed(uint32_t category) const { return category < max_categories && ((m_fixed_categories >> category) & 1); }
+		bool is_moving(uint32_t category) const { return category < max_categories && ((m_moving_categories >> category) & 1); }
+		void build_tree(rynx::ecs& ecs);
+		void build_node(int32_t node, int32_t begin, int32_t end);
+		void update_moving(rynx::ecs& ecs);
+		void find_pairs();
+
+		uint64_t mask(uint32_t category) const { return category < max_categories ? m_enabled[category] : 0; }
+
+		std::array<uint64_t, max_categories> m_enabled{};
+		uint64_t m_moving_categories = 0;
+		uint64_t m_fixed_categories = 0;
+
+		std::vector<fixed_proxy> m_fixed;
+		std::vector<tree_node> m_tree;
+		std::unordered_set<uint64_t> m_fixed_ids;
+		uint64_t m_tree_tick = 0;
+		bool m_tree_built = false;
+		int32_t m_static_rebuilds = 0;
+
+		std::vector<moving_proxy> m_moving;
+		std::unordered_map<uint64_t, int32_t> m_moving_slot;
+		std::vector<sweep_entry> m_sweep;
+		uint32_t m_stamp = 0;
+
+		std::vector<pair> m_pairs;
+	};
+}
@@ -0,0 +1,20 @@
+#include <game/camera_requests.hpp>
+
+#include <rynx/graphics/camera/camera.hpp>
+
+void game::camera_requests::apply(rynx::camera& camera) {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (m_rotation.length_squared() > 0.0f) {
+		camera.rotate(m_rotation);
+	}
+	if (m_translation.length_squared() > 0.0f) {
+		camera.translate(m_translation);
+	}
+	if (m_position) {
+		camera.setPosition(*m_position);
+	}
+
+	m_position.reset();
+	m_rotation = {};
+	m_translation = {};
+}
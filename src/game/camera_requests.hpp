@@ -0,0 +1,44 @@
+#pragma once
+
+#include <rynx/math/vector.hpp>
+
+#include <mutex>
+#include <optional>
+
+namespace rynx {
+	class camera;
+}
+
+namespace game {
+	// camera moves requested from logic tasks. the first logic tick of a frame runs while the renderer and
+	// the background draw read the camera on the main thread, so tasks do not move the camera themselves.
+	// they record the move here and main applies it after the tick has completed.
+	// recording takes a short lock, so tasks take this resource as const.
+	class camera_requests {
+	public:
+		void set_position(rynx::vec3f position) const {
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_position = position;
+		}
+
+		void rotate(rynx::vec3f amount) const {
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_rotation += amount;
+		}
+
+		void translate(rynx::vec3f amount) const {
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_translation += amount;
+		}
+
+		// rotation and translation first, a requested position overrides the translation.
+		// must be called while no tasks are running.
+		void apply(rynx::camera& camera);
+
+	private:
+		mutable std::mutex m_mutex;
+		mutable std::optional<rynx::vec3f> m_position;
+		mutable rynx::vec3f m_rotation;
+		mutable rynx::vec3f m_translation;
+	};
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <game/broadphase.hpp>
+
+#include <rynx/tech/collision_detection.hpp>
+
+#include <utility>
+#include <vector>
+
+class game_collisions {
+public:
+	game_collisions(rynx::collision_detection& collisionDetection) {
+		collisionCategoryDynamic = collisionDetection.add_category();
+		collisionCategoryStatic = collisionDetection.add_category();
+		collisionCategoryProjectiles = collisionDetection.add_category();
+		collisionCategoryTerrain = collisionDetection.add_category();
+		collisionCategoryWheels = collisionDetection.add_category();
+
+		{
+			enable(collisionDetection, collisionCategoryDynamic, collisionCategoryDynamic); // enable dynamic <-> dynamic collisions
+			enable_static(collisionDetection, collisionCategoryDynamic, collisionCategoryStatic); // enable dynamic <-> static collisions
+			enable_static(collisionDetection, collisionCategoryDynamic, collisionCategoryTerrain); // enable dynamic <-> terrain collisions
+
+			enable_static(collisionDetection, collisionCategoryProjectiles, collisionCategoryStatic); // projectile <-> static
+			enable_static(collisionDetection, collisionCategoryProjectiles, collisionCategoryTerrain); // projectile <-> terrain
+			enable(collisionDetection, collisionCategoryProjectiles, collisionCategoryDynamic); // projectile <-> dynamic
+			enable(collisionDetection, collisionCategoryProjectiles, collisionCategoryWheels); // projectile <-> wheels
+
+			// wheels vs terrain is not handled here, game::height_field_collisions takes care of that.
+			enable(collisionDetection, collisionCategoryWheels, collisionCategoryWheels); // wheels <-> wheels
+			enable(collisionDetection, collisionCategoryWheels, collisionCategoryDynamic); // wheels <-> dynamic
+			enable_static(collisionDetection, collisionCategoryWheels, collisionCategoryStatic); // wheels <-> static
+		}
+	}
+
+	// the same categories and pairs for the game's own broadphase. static and terrain are its fixed categories.
+	void configure(game::broadphase& broadphase) const {
+		broadphase.add_moving_category(collisionCategoryDynamic);
+		broadphase.add_moving_category(collisionCategoryProjectiles);
+		broadphase.add_moving_category(collisionCategoryWheels);
+		broadphase.add_fixed_category(collisionCategoryStatic);
+		broadphase.add_fixed_category(collisionCategoryTerrain);
+		for (const auto& [a, b] : m_enabled) {
+			broadphase.enable_pair(a, b);
+		}
+	}
+
+	rynx::collision_detection::category_id category_dynamic() const { return collisionCategoryDynamic; }
+	rynx::collision_detection::category_id category_static() const { return collisionCategoryStatic; }
+	rynx::collision_detection::category_id category_projectiles() const { return collisionCategoryProjectiles; }
+	rynx::collision_detection::category_id category_terrain() const { return collisionCategoryTerrain; }
+	rynx::collision_detection::category_id category_wheels() const { return collisionCategoryWheels; }
+
+private:
+	using category_pair = std::pair<rynx::collision_detection::category_id, rynx::collision_detection::category_id>;
+
+	void enable(rynx::collision_detection& collisionDetection, rynx::collision_detection::category_id a, rynx::collision_detection::category_id b) {
+		collisionDetection.enable_collisions_between(a, b);
+		m_enabled.emplace_back(a, b);
+	}
+
+	// b never moves, its entities are not tested against each other.
+	void enable_static(rynx::collision_detection& collisionDetection, rynx::collision_detection::category_id a, rynx::collision_detection::category_id b) {
+		collisionDetection.enable_collisions_between(a, b.ignore_collisions());
+		m_enabled.emplace_back(a, b);
+	}
+
+	rynx::collision_detection::category_id collisionCategoryDynamic;
+	rynx::collision_detection::category_id collisionCategoryStatic;
+	rynx::collision_detection::category_id collisionCategoryProjectiles;
+	rynx::collision_detection::category_id collisionCategoryTerrain;
+	rynx::collision_detection::category_id collisionCategoryWheels;
+	std::vector<category_pair> m_enabled;
+};
@@ -1,4 +1,20 @@
+#pragma once
+
+#include <cstdint>
 
 namespace game {
 	struct hero_tag {};
-}
\ No newline at end of file
+
+	namespace components {
+		// tags spring joints that act as vehicle suspension.
+		struct suspension {};
+
+		// suspension aggregate of one vehicle, stored on the vehicle body and written by game::suspension_tracking.
+		struct suspension_state {
+			float compression = 0.0f; // summed rest length minus current length of the suspension joints.
+			float velocity = 0.0f; // rate of change of compression, per second.
+			float peak = 0.0f; // largest recent absolute velocity, decays over time.
+			int32_t joint_count = 0;
+		};
+	}
+}
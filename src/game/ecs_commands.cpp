@@ -0,0 +1,79 @@
+
+#include <game/ecs_commands.hpp>
+#include <game/transform_changes.hpp>
+
+#include <rynx/scheduler/context.hpp>
+#include <rynx/tech/profiling.hpp>
+
+#include <algorithm>
+
+void game::ecs_commands::erase(rynx::ecs::id id) const {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_erases.emplace_back(id);
+}
+
+void game::ecs_commands::apply(
+	rynx::ecs& ecs,
+	rynx::collision_detection& detection,
+	rynx::application::logic& logic,
+	rynx::scheduler::context& context)
+{
+	rynx_profile("Game", "apply ecs commands");
+	const auto& changes = context.get_resource<game::transform_changes>();
+
+	std::vector<rynx::ecs::id> ids_erased;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		ids_erased.swap(m_erases);
+	}
+
+	{
+		auto ids_dead = ecs.query().in<rynx::components::dead>().ids();
+		ids_erased.insert(ids_erased.end(), ids_dead.begin(), ids_dead.end());
+	}
+
+	// the same entity may be both recorded and tagged dead, or recorded from several tasks.
+	std::sort(ids_erased.begin(), ids_erased.end(), [](rynx::ecs::id a, rynx::ecs::id b) { return a.value < b.value; });
+	ids_erased.erase(std::unique(ids_erased.begin(), ids_erased.end(), [](rynx::ecs::id a, rynx::ecs::id b) { return a.value == b.value; }), ids_erased.end());
+	ids_erased.erase(std::remove_if(ids_erased.begin(), ids_erased.end(), [&ecs](rynx::ecs::id id) { return !ecs.exists(id); }), ids_erased.end());
+
+	if (!ids_erased.empty()) {
+		// collision detection erases are grouped per category, in id order within a category.
+		m_collision_erases.clear();
+		for (auto id : ids_erased) {
+			if (const auto* collisions = ecs[id].try_get<rynx::components::collisions>()) {
+				m_collision_erases.emplace_back(collisions->category, id);
+			}
+		}
+
+		std::stable_sort(m_collision_erases.begin(), m_collision_erases.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+		for (const auto& [category, id] : m_collision_erases) {
+			detection.erase(ecs, id.value, category);
+		}
+
+		for (auto id : ids_erased) {
+			changes.mark(id);
+		}
+
+		logic.entities_erased(context, ids_erased);
+		ecs.erase(ids_erased);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_pending_creates.swap(m_creates);
+	}
+	for (auto& create : m_pending_creates) {
+		changes.mark(create(ecs));
+	}
+	m_pending_creates.clear();
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_pending.swap(m_attaches);
+	}
+	for (auto& attach : m_pending) {
+		attach(ecs);
+	}
+	m_pending.clear();
+}
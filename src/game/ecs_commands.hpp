@@ -0,0 +1,70 @@
+#pragma once
+
+#include <rynx/application/logic.hpp>
+#include <rynx/tech/collision_detection.hpp>
+#include <rynx/tech/components.hpp>
+#include <rynx/tech/ecs.hpp>
+
+#include <functional>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+namespace rynx {
+	namespace scheduler {
+		class context;
+	}
+}
+
+namespace game {
+	// structural ecs changes recorded from inside scheduler tasks and applied in one pass at the end of a logic tick.
+	// recording only takes a short lock, so tasks can take this resource as const and still run in parallel
+	// instead of requiring exclusive access to the whole ecs.
+	class ecs_commands {
+	public:
+		template<typename... Components>
+		void create(Components&&... components) const {
+			auto command = [... components = std::decay_t<Components>(std::forward<Components>(components))](rynx::ecs& ecs) mutable {
+				return ecs.create(std::move(components)...);
+			};
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_creates.emplace_back(std::move(command));
+		}
+
+		// attaching to an entity that no longer exists when commands are applied is ignored.
+		template<typename Component>
+		void attach(rynx::ecs::id id, Component&& component) const {
+			auto command = [id, component = std::decay_t<Component>(std::forward<Component>(component))](rynx::ecs& ecs) mutable {
+				if (ecs.exists(id)) {
+					ecs.attachToEntity(id, std::move(component));
+				}
+			};
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_attaches.emplace_back(std::move(command));
+		}
+
+		void erase(rynx::ecs::id id) const;
+
+		// erases first, including every entity tagged dead, then creates, then attaches.
+		// erased and created entities are marked in game::transform_changes, which must be a resource of the context.
+		// must be called while no tasks are running.
+		void apply(
+			rynx::ecs& ecs,
+			rynx::collision_detection& detection,
+			rynx::application::logic& logic,
+			rynx::scheduler::context& context);
+
+	private:
+		mutable std::mutex m_mutex;
+		mutable std::vector<std::function<rynx::ecs::id(rynx::ecs&)>> m_creates;
+		mutable std::vector<std::function<void(rynx::ecs&)>> m_attaches;
+		mutable std::vector<rynx::ecs::id> m_erases;
+
+		// reused between ticks.
+		std::vector<std::function<rynx::ecs::id(rynx::ecs&)>> m_pending_creates;
+		std::vector<std::function<void(rynx::ecs&)>> m_pending;
+		std::vector<std::pair<decltype(rynx::components::collisions::category), rynx::ecs::id>> m_collision_erases;
+	};
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <rynx/tech/components.hpp>
+#include <rynx/application/components.hpp>
+#include <rynx/tech/collision_detection.hpp>
+#include <rynx/math/geometry/polygon.hpp>
+#include <rynx/math/vector.hpp>
+#include <rynx/math/matrix.hpp>
+
+#include <game/static_body.hpp>
+
+#include <tuple>
+
+namespace game {
+	// component sets of the shapes the editor spawns. the benchmark spawns through the same functions,
+	// so that it measures exactly what a player piling up crates in the editor gets.
+
+	inline auto dynamic_box(const rynx::polygon& shape, rynx::vec3f pos, rynx::collision_detection::category_id category) {
+		return std::make_tuple(
+			rynx::components::position(pos, 0.0f),
+			rynx::components::motion{},
+			rynx::components::collisions{ category.value },
+			rynx::components::boundary(shape, pos, 0.0f),
+			rynx::components::radius(shape.radius()),
+			rynx::components::color({ 0.2f, 1.0f, 0.3f, 1.0f }),
+			rynx::components::physical_body(rynx::components::physical_body().mass(550.0f).friction(1.0f).elasticity(0.0f).moment_of_inertia(shape, 2.0f)),
+			rynx::matrix4{}
+		);
+	}
+
+	inline auto static_polygon(const rynx::polygon& shape, rynx::vec3f pos, rynx::collision_detection::category_id category) {
+		return std::make_tuple(
+			rynx::components::position(pos, 0.0f),
+			rynx::components::collisions{ category.value },
+			rynx::components::boundary(shape, pos, 0.0f),
+			rynx::components::radius(shape.radius()),
+			rynx::components::color({ 0.2f, 1.0f, 0.3f, 1.0f }),
+			game::static_body(),
+			rynx::components::ignore_gravity(),
+			rynx::components::dampening{ 0.50f, 1.0f }
+		);
+	}
+}
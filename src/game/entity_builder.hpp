@@ -0,0 +1,60 @@
+#pragma once
+
+#include <rynx/tech/ecs.hpp>
+
+#include <cstddef>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace game {
+	namespace detail {
+		template<typename T> struct is_tuple : std::false_type {};
+		template<typename... Ts> struct is_tuple<std::tuple<Ts...>> : std::true_type {};
+
+		template<typename T>
+		auto as_tuple(T&& value) {
+			if constexpr (is_tuple<std::decay_t<T>>::value) {
+				return std::forward<T>(value);
+			}
+			else {
+				return std::tuple<std::decay_t<T>>(std::forward<T>(value));
+			}
+		}
+
+		template<typename... Present>
+		rynx::ecs::id create_from(rynx::ecs& ecs, std::tuple<Present...>&& present) {
+			return std::apply([&ecs](auto&&... components) { return ecs.create(std::move(components)...); }, std::move(present));
+		}
+
+		template<typename... Present, typename Next, typename... Rest>
+		rynx::ecs::id create_from(rynx::ecs& ecs, std::tuple<Present...>&& present, std::optional<Next>&& next, std::optional<Rest>&&... rest) {
+			if (next) {
+				return create_from(ecs, std::tuple_cat(std::move(present), as_tuple(std::move(*next))), std::move(rest)...);
+			}
+			return create_from(ecs, std::move(present), std::move(rest)...);
+		}
+	}
+
+	// creates an entity with its whole component set in one go, so it lands directly in its final table
+	// instead of moving tables once per attachToEntity. components that are only known at runtime are given
+	// as optionals, a tuple inside an optional adds all of its components together.
+	// every present / missing combination instantiates its own ecs.create, so keep the optionals few.
+	template<typename... Components, typename... Optionals>
+	rynx::ecs::id create_entity(rynx::ecs& ecs, std::tuple<Components...> components, std::optional<Optionals>... optionals) {
+		return detail::create_from(ecs, std::move(components), std::move(optionals)...);
+	}
+
+	// creates count entities, make(i) returns a tuple of components for the i'th entity. each one is a separate
+	// ecs.create straight into its final table, rynx::ecs has no bulk insert to hand the whole run to.
+	// ids are appended to out in creation order.
+	template<typename Make>
+	void create_each(rynx::ecs& ecs, size_t count, Make&& make, std::vector<rynx::ecs::id>& out) {
+		out.reserve(out.size() + count);
+		for (size_t i = 0; i < count; ++i) {
+			out.emplace_back(detail::create_from(ecs, detail::as_tuple(make(i))));
+		}
+	}
+}
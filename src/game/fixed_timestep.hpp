@@ -0,0 +1,42 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace game {
+	// accumulates frame time and hands it out as whole logic ticks of a fixed size.
+	// if the frame falls too far behind, the backlog beyond max_ticks_per_frame is dropped
+	// instead of trying to catch up, so a slow frame can not snowball into slower frames.
+	class fixed_timestep {
+	public:
+		fixed_timestep(float tick_length = 1.0f / 120.0f, int32_t max_ticks_per_frame = 8)
+			: m_tick_length(tick_length)
+			, m_max_ticks_per_frame(max_ticks_per_frame)
+		{}
+
+		// returns the number of ticks to run for a frame that took frame_time seconds.
+		int32_t advance(float frame_time) {
+			m_accumulator += std::max(frame_time, 0.0f);
+			int32_t ticks = static_cast<int32_t>(m_accumulator / m_tick_length);
+			if (ticks > m_max_ticks_per_frame) {
+				ticks = m_max_ticks_per_frame;
+				m_accumulator = std::fmod(m_accumulator, m_tick_length);
+			}
+			else {
+				m_accumulator -= ticks * m_tick_length;
+			}
+			return ticks;
+		}
+
+		float tick_length() const { return m_tick_length; }
+		
+		// how far the current frame is between the last two logic states, in [0, 1).
+		float alpha() const { return std::clamp(m_accumulator / m_tick_length, 0.0f, 1.0f); }
+
+	private:
+		float m_tick_length;
+		int32_t m_max_ticks_per_frame;
+		float m_accumulator = 0.0f;
+	};
+}
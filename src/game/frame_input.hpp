@@ -0,0 +1,68 @@
+#pragma once
+
+#include <rynx/input/key_types.hpp>
+#include <rynx/input/mapped_input.hpp>
+#include <rynx/math/vector.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace game {
+	// edge triggered input for logic running on a fixed timestep. rynx refreshes clicked, pressed, released
+	// and mouse delta once per rendered frame, but a frame runs any number of logic ticks, including none.
+	// read directly from a ruleset an edge is seen twice when a frame runs two ticks and lost when it runs none.
+	//
+	// rulesets track the keys they react to on edges, main collects those edges once per frame and the
+	// first logic tick after that sees them. held keys (isKeyDown) are level triggered and can be read directly.
+	class frame_input {
+	public:
+		using edge_id = int32_t;
+
+		edge_id track(rynx::key::logical key) {
+			m_keys.emplace_back(key);
+			m_pending.emplace_back();
+			m_current.emplace_back();
+			return static_cast<edge_id>(m_keys.size() - 1);
+		}
+
+		// once per rendered frame, after menus have consumed the input they use.
+		// edges of frames that ran no logic tick stay pending until the next tick.
+		void collect(rynx::mapped_input& input) {
+			for (size_t i = 0; i < m_keys.size(); ++i) {
+				m_pending[i].clicked |= input.isKeyClicked(m_keys[i]);
+				m_pending[i].pressed |= input.isKeyPressed(m_keys[i]);
+				m_pending[i].released |= input.isKeyReleased(m_keys[i]);
+			}
+			m_pending_mouse_delta += input.mouseDelta();
+		}
+
+		// before generating the tasks of each logic tick, while no tasks are running.
+		// a later tick of the same frame sees no edges and no mouse movement.
+		void begin_tick() {
+			m_current.swap(m_pending);
+			for (auto& key_edges : m_pending) {
+				key_edges = {};
+			}
+			m_current_mouse_delta = m_pending_mouse_delta;
+			m_pending_mouse_delta = {};
+		}
+
+		bool clicked(edge_id id) const { return m_current[id].clicked; }
+		bool pressed(edge_id id) const { return m_current[id].pressed; }
+		bool released(edge_id id) const { return m_current[id].released; }
+		rynx::vec3f mouse_delta() const { return m_current_mouse_delta; }
+
+	private:
+		struct edges {
+			bool clicked = false;
+			bool pressed = false;
+			bool released = false;
+		};
+
+		std::vector<rynx::key::logical> m_keys;
+		std::vector<edges> m_pending;
+		std::vector<edges> m_current;
+		rynx::vec3f m_pending_mouse_delta;
+		rynx::vec3f m_current_mouse_delta;
+	};
+}
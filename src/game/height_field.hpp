@@ -0,0 +1,52 @@
+#pragma once
+
+#include <rynx/math/vector.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace game {
+	namespace components {
+		
+		// terrain surface stored as evenly spaced world space height samples.
+		// all queries are O(1), the segment under any x is found by a single division.
+		struct height_field {
+			float x_begin = 0.0f;
+			float spacing = 10.0f;
+			std::vector<float> heights;
+
+			float x_end() const { return x_begin + spacing * (int32_t(heights.size()) - 1); }
+			bool overlaps(float x_min, float x_max) const { return x_max >= x_begin && x_min <= x_end(); }
+			int32_t num_segments() const { return std::max(int32_t(heights.size()) - 1, 0); }
+
+			int32_t segment_index(float x) const {
+				int32_t index = static_cast<int32_t>(std::floor((x - x_begin) / spacing));
+				return std::clamp(index, 0, num_segments() - 1);
+			}
+
+			rynx::vec3f segment_begin(int32_t index) const { return { x_begin + index * spacing, heights[index], 0.0f }; }
+			rynx::vec3f segment_end(int32_t index) const { return { x_begin + (index + 1) * spacing, heights[index + 1], 0.0f }; }
+			
+			rynx::vec3f segment_normal(int32_t index) const {
+				float dy = heights[index + 1] - heights[index];
+				float inv_length = 1.0f / std::sqrt(dy * dy + spacing * spacing);
+				return { -dy * inv_length, spacing * inv_length, 0.0f };
+			}
+
+			float height(float x) const {
+				int32_t index = segment_index(x);
+				float t = (x - x_begin) / spacing - index;
+				return heights[index] + (heights[index + 1] - heights[index]) * t;
+			}
+
+			rynx::vec3f normal(float x) const {
+				return segment_normal(segment_index(x));
+			}
+		};
+
+		// circle bodies with this tag are resolved against height fields by game::height_field_collisions.
+		struct height_field_body {};
+	}
+}
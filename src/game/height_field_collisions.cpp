@@ -0,0 +1,244 @@
+
+#include <game/height_field_collisions.hpp>
+#include <game/height_field.hpp>
+#include <game/parallel_reduce.hpp>
+#include <game/segment_kernels.hpp>
+
+#include <rynx/scheduler/context.hpp>
+#include <rynx/tech/components.hpp>
+#include <rynx/tech/profiling.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+void game::height_field_collisions::onFrameProcess(rynx::scheduler::context& context, float dt) {
+	context.add_task("height field collisions", [this, dt](
+		rynx::ecs::view<
+			const game::components::height_field,
+			const game::components::height_field_body,
+			const rynx::components::radius,
+			const rynx::components::physical_body,
+			rynx::components::position,
+			rynx::components::motion,
+			rynx::components::collision_custom_reaction> ecs,
+		rynx::scheduler::task& task_context)
+	{
+		rynx_profile("Game", "height field collisions");
+
+		struct terrain_entry {
+			rynx::ecs::id id;
+			const game::components::height_field* field;
+			const rynx::components::physical_body* body;
+		};
+
+		std::vector<terrain_entry> terrain;
+		ecs.query().for_each([&](rynx::ecs::id id, const game::components::height_field& field, const rynx::components::physical_body& body) {
+			if (field.num_segments() > 0) {
+				terrain.emplace_back(terrain_entry{ id, &field, &body });
+			}
+		});
+
+		if (terrain.empty()) {
+			m_cache.clear();
+			return;
+		}
+
+		auto solve_body = [&](rynx::ecs::id id, std::vector<contact>& contacts, std::vector<cached_contact>& cache_out) {
+			auto entity = ecs[id];
+			auto* pos_ptr = entity.try_get<rynx::components::position>();
+			auto* mot_ptr = entity.try_get<rynx::components::motion>();
+			const auto* radius = entity.try_get<const rynx::components::radius>();
+			const auto* body_ptr = entity.try_get<const rynx::components::physical_body>();
+			if (!pos_ptr || !mot_ptr || !radius || !body_ptr) {
+				return;
+			}
+
+			const auto& body = *body_ptr;
+			const game::vec2 center(pos_ptr->value);
+			game::velocity2d velocity = game::velocity2d::from(*mot_ptr);
+			const float r = radius->r;
+			contacts.clear();
+
+			for (const auto& entry : terrain) {
+				const auto& field = *entry.field;
+				if (!field.overlaps(center.x - r, center.x + r)) {
+					continue;
+				}
+
+				const int32_t first = field.segment_index(center.x - r);
+				const int32_t last = field.segment_index(center.x + r);
+
+				// heights are already laid out as segment start and end y, only x is generated per batch.
+				constexpr int32_t batch = 16;
+				float ax[batch], bx[batch];
+				game::segment_contact hits[batch];
+				for (int32_t batch_first = first; batch_first <= last; batch_first += batch) {
+					const int32_t count = std::min(batch, last - batch_first + 1);
+					for (int32_t k = 0; k < count; ++k) {
+						ax[k] = field.x_begin + (batch_first + k) * field.spacing;
+						bx[k] = ax[k] + field.spacing;
+					}
+
+					const int32_t num_hits = game::circle_vs_segments(
+						ax, field.heights.data() + batch_first, bx, field.heights.data() + batch_first + 1, count,
+						center.x, center.y, r, hits);
+
+					for (int32_t h = 0; h < num_hits; ++h) {
+						const int32_t i = batch_first + hits[h].segment;
+						const game::vec2 normal(hits[h].normal_x, hits[h].normal_y);
+						const float penetration = hits[h].depth;
+
+						// a wheel resting on a vertex gets the same contact from both segments that share it, and one on a flat
+						// stretch or a chunk seam gets parallel ones. solving each of them would multiply the push out, so only
+						// the deepest contact per direction is kept.
+						auto same = std::find_if(contacts.begin(), contacts.end(), [&](const contact& other) { return other.normal.dot(normal) > 0.999f; });
+						if (same != contacts.end() && same->penetration >= penetration) {
+							continue;
+						}
+
+						contact c;
+						c.terrain = entry.id.value;
+						c.segment = i;
+						c.normal = normal;
+						c.tangent = game::vec2(-normal.y, normal.x);
+						c.offset = normal * -r;
+						c.penetration = penetration;
+						c.friction = body.friction_multiplier * entry.body->friction_multiplier;
+
+						const float rn = c.offset.cross(c.normal);
+						const float rt = c.offset.cross(c.tangent);
+						const float kn = body.inv_mass + body.inv_moment_of_inertia * rn * rn;
+						const float kt = body.inv_mass + body.inv_moment_of_inertia * rt * rt;
+						c.rn = rn;
+						c.rt = rt;
+						c.inv_kn = (kn > 0.0f) ? 1.0f / kn : 0.0f;
+						c.inv_kt = (kt > 0.0f) ? 1.0f / kt : 0.0f;
+
+						c.contact_velocity = velocity.at(c.offset);
+						const float elasticity = body.collision_elasticity * entry.body->collision_elasticity;
+						c.target_velocity = -elasticity * std::min(c.contact_velocity.dot(normal), 0.0f);
+
+						if (same != contacts.end()) {
+							*same = c;
+						}
+						else {
+							contacts.emplace_back(c);
+						}
+					}
+				}
+			}
+
+			if (contacts.empty()) {
+				return;
+			}
+
+			warm_start(id.value, contacts);
+
+			auto apply_impulse = [&](const contact& c, float normal_impulse, float tangent_impulse) {
+				velocity.linear += (c.normal * normal_impulse + c.tangent * tangent_impulse) * body.inv_mass;
+				velocity.angular += body.inv_moment_of_inertia * (c.rn * normal_impulse + c.rt * tangent_impulse);
+			};
+
+			// warm start from last tick's impulses. a resting wheel starts out already supported.
+			for (const auto& c : contacts) {
+				apply_impulse(c, c.normal_impulse, c.tangent_impulse);
+			}
+
+			// terrain does not move, so contacts of one body only interact with each other and can be solved body by body.
+			for (int32_t iteration = 0; iteration < m_iterations; ++iteration) {
+				for (auto& c : contacts) {
+					const float normal_velocity = velocity.at(c.offset).dot(c.normal);
+					const float normal_impulse = std::max(c.normal_impulse + (c.target_velocity - normal_velocity) * c.inv_kn, 0.0f);
+					apply_impulse(c, normal_impulse - c.normal_impulse, 0.0f);
+					c.normal_impulse = normal_impulse;
+
+					const float tangent_velocity = velocity.at(c.offset).dot(c.tangent);
+					const float max_friction = c.friction * c.normal_impulse;
+					const float tangent_impulse = std::clamp(c.tangent_impulse - tangent_velocity * c.inv_kt, -max_friction, +max_friction);
+					apply_impulse(c, 0.0f, tangent_impulse - c.tangent_impulse);
+					c.tangent_impulse = tangent_impulse;
+				}
+			}
+
+			game::vec2 correction;
+			auto* reaction = entity.try_get<rynx::components::collision_custom_reaction>();
+			for (const auto& c : contacts) {
+				correction += c.normal * (std::max(c.penetration - m_allowed_penetration, 0.0f) * m_position_correction);
+				cache_out.emplace_back(cached_contact{ id.value, c.terrain, c.segment, c.normal_impulse, c.tangent_impulse });
+
+				if (reaction) {
+					auto& event = reaction->events.emplace_back();
+					event.id = c.terrain;
+					event.normal = c.normal.xyz();
+					event.relative_velocity = c.contact_velocity.xyz();
+				}
+			}
+
+			pos_ptr->value.x += correction.x;
+			pos_ptr->value.y += correction.y;
+			mot_ptr->velocity.x = velocity.linear.x;
+			mot_ptr->velocity.y = velocity.linear.y;
+			mot_ptr->angularVelocity = velocity.angular;
+		};
+
+		// bodies only touch static terrain and write nothing but their own components, so chunks of bodies
+		// are solved in parallel. cache entries of each chunk are concatenated in chunk order.
+		auto ids = ecs.query().in<game::components::height_field_body>().ids();
+		m_next_cache = game::parallel_reduce(task_context, ids.size(), 64, std::vector<cached_contact>(),
+			[&](size_t begin, size_t end) {
+				std::vector<cached_contact> cache_out;
+				std::vector<contact> contacts;
+				for (size_t i = begin; i < end; ++i) {
+					solve_body(ids[i], contacts, cache_out);
+				}
+				return cache_out;
+			},
+			[](std::vector<cached_contact> a, std::vector<cached_contact> b) {
+				a.insert(a.end(), b.begin(), b.end());
+				return a;
+			});
+
+		std::sort(m_next_cache.begin(), m_next_cache.end(), [](const cached_contact& a, const cached_contact& b) { return a.key() < b.key(); });
+		m_cache.swap(m_next_cache);
+	});
+}
+
+// each cached contact warm starts at most one new contact. exact segment matches are taken first, then a
+// neighbouring segment of the same terrain, since a rolling wheel moves its contact from segment to segment.
+// handing one cached impulse to two contacts would double the warm start.
+void game::height_field_collisions::warm_start(uint64_t body, std::vector<contact>& contacts) const {
+	auto begin = std::lower_bound(m_cache.begin(), m_cache.end(), body, [](const cached_contact& c, uint64_t b) { return c.body < b; });
+	auto end = std::upper_bound(begin, m_cache.end(), body, [](uint64_t b, const cached_contact& c) { return b < c.body; });
+	if (begin == end) {
+		return;
+	}
+
+	// a body has a handful of contacts, more than 64 on either side are left cold.
+	const size_t num_cached = std::min<size_t>(end - begin, 64);
+	const size_t num_contacts = std::min<size_t>(contacts.size(), 64);
+	uint64_t cached_used = 0;
+	uint64_t contact_done = 0;
+
+	for (int32_t max_offset : { 0, 1 }) {
+		for (size_t i = 0; i < num_contacts; ++i) {
+			if (contact_done & (uint64_t(1) << i)) {
+				continue;
+			}
+
+			auto& c = contacts[i];
+			for (size_t k = 0; k < num_cached; ++k) {
+				const auto& cached = begin[k];
+				if ((cached_used & (uint64_t(1) << k)) || cached.terrain != c.terrain || std::abs(cached.segment - c.segment) != max_offset) {
+					continue;
+				}
+
+				c.normal_impulse = cached.normal_impulse;
+				c.tangent_impulse = cached.tangent_impulse;
+				cached_used |= uint64_t(1) << k;
+				contact_done |= uint64_t(1) << i;
+				break;
+			}
+		}
+	}
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <game/transform2d.hpp>
+
+#include <rynx/application/logic.hpp>
+#include <rynx/math/vector.hpp>
+
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+namespace game {
+	// resolves circle bodies tagged with game::components::height_field_body against terrain height fields.
+	// each body is only tested against the few height field segments directly under it, instead of
+	// going through the general polygon narrow phase.
+	// contacts are cached per body, terrain entity and segment, and accumulated impulses are carried over to the
+	// next tick as a warm start. a resting wheel is already supported when the iterations begin, so few are needed.
+	// bodies are independent of each other and solved in parallel chunks on the scheduler workers.
+	// each body is solved on a planar copy of its pose and velocity that is written back once.
+	class height_field_collisions : public rynx::application::logic::iruleset {
+	public:
+		height_field_collisions(float position_correction = 0.8f, float allowed_penetration = 0.5f, int32_t iterations = 2)
+			: m_position_correction(position_correction)
+			, m_allowed_penetration(allowed_penetration)
+			, m_iterations(iterations)
+		{}
+
+		virtual ~height_field_collisions() = default;
+		virtual void onFrameProcess(rynx::scheduler::context& context, float dt) override;
+	
+	private:
+		struct contact {
+			uint64_t terrain = 0;
+			int32_t segment = 0;
+			game::vec2 normal;
+			game::vec2 tangent;
+			game::vec2 offset; // from body center to the contact point.
+			game::vec2 contact_velocity; // before solving, reported in collision events.
+			float penetration = 0.0f;
+			float friction = 0.0f;
+			float rn = 0.0f, rt = 0.0f;
+			float inv_kn = 0.0f, inv_kt = 0.0f;
+			float target_velocity = 0.0f;
+			float normal_impulse = 0.0f;
+			float tangent_impulse = 0.0f;
+		};
+
+		struct cached_contact {
+			uint64_t body;
+			uint64_t terrain;
+			int32_t segment;
+			float normal_impulse;
+			float tangent_impulse;
+
+			auto key() const { return std::make_tuple(body, terrain, segment); }
+		};
+
+		void warm_start(uint64_t body, std::vector<contact>& contacts) const;
+
+		float m_position_correction;
+		float m_allowed_penetration;
+		int32_t m_iterations;
+
+		std::vector<cached_contact> m_cache; // last tick, sorted by key.
+		std::vector<cached_contact> m_next_cache;
+	};
+}
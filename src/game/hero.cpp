@@ -8,19 +8,15 @@
 
 #include <rynx/audio/audio.hpp>
 #include <game/menu.hpp>
+#include <game/camera_requests.hpp>
 #include <rynx/graphics/camera/camera.hpp>
 #include <rynx/math/geometry/ray.hpp>
 #include <rynx/math/geometry/plane.hpp>
 #include <rynx/math/matrix.hpp>
 
-namespace game {
-	namespace components {
-		struct suspension { float prev_length = 0.0f; };
-	}
-}
-
 game::hero_control::hero_control(
 	rynx::mapped_input& input,
+	game::frame_input& edges,
 	rynx::ecs::id back_wheel,
 	rynx::ecs::id front_wheel,
 	rynx::ecs::id head,
@@ -34,6 +30,7 @@ game::hero_control::hero_control(
 
 	key_construct = input.generateAndBindGameKey('E', "construct");
 	key_shoot = input.generateAndBindGameKey(input.getMouseKeyPhysical(0), "shoot");
+	edge_construct = edges.track(key_construct);
 
 	engine_wheel_id = back_wheel;
 	break_wheel_id = front_wheel;
@@ -44,9 +41,11 @@ game::hero_control::hero_control(
 
 void game::hero_control::onFrameProcess(rynx::scheduler::context& context, float dt) {
 	context.add_task("hero inputs", [this, dt](
-		rynx::ecs::view<const rynx::components::collision_custom_reaction, game::components::suspension, const rynx::components::phys::joint, rynx::components::particle_emitter, rynx::components::position, rynx::components::motion, rynx::components::phys::joint, const rynx::components::physical_body, const game::hero_tag> ecs,
+		rynx::ecs::view<const rynx::components::collision_custom_reaction, const game::components::suspension_state, const rynx::components::phys::joint, rynx::components::particle_emitter, rynx::components::position, rynx::components::motion, rynx::components::phys::joint, const rynx::components::physical_body, const game::hero_tag> ecs,
 		rynx::mapped_input& input,
+		const game::frame_input& edges,
 		rynx::sound::audio_system& audio,
+		const game::camera_requests& camera_moves,
 		rynx::camera& camera)
 	{
 		constexpr float max_speed = 75;
@@ -59,19 +58,14 @@ void game::hero_control::onFrameProcess(rynx::scheduler::context& context, float
 			lookAtWorldPos = mousecast.first;
 		}
 
-		float total_suspension_velocity = 0.0f;
-		ecs.query().for_each([&](game::components::suspension& suspension, const rynx::components::phys::joint& j) {
-			float current_length = rynx::components::phys::compute_current_joint_length(j, ecs);
-			total_suspension_velocity += current_length - j.length;
-			suspension.prev_length = current_length;
-		});
-		total_suspension_velocity *= 0.10f;
-
 		if (ecs.exists(bike_body_id)) {
 			auto entity = ecs[bike_body_id];
 			const auto& body_pos = ecs[bike_body_id].get<const rynx::components::position>();
 			const auto* mot = entity.try_get<const rynx::components::motion>();
-			camera.setPosition(body_pos.value + mot->velocity * 1.0f + rynx::vec3f{0, 0, 750});
+			camera_moves.set_position(body_pos.value + mot->velocity * 1.0f + rynx::vec3f{0, 0, 750});
+
+			const auto* suspension = entity.try_get<const game::components::suspension_state>();
+			float total_suspension_velocity = suspension ? suspension->compression * -0.10f : 0.0f;
 
 			if (bike_constant_bg.completion_rate() > 0.8f) {
 				bike_constant_bg = audio.play_sound("bike_rest", body_pos.value, {}, 0.4f);
@@ -93,26 +87,45 @@ void game::hero_control::onFrameProcess(rynx::scheduler::context& context, float
 				}
 			}
 
-			ecs.query().for_each([&](const rynx::components::collision_custom_reaction& collisions, const rynx::components::motion& my_motion) {
-				for (auto&& event : collisions.events) {
+			// strongest roll and bump over the collision events of the hero's own bike this tick, each sound is triggered at most once.
+			struct wheel_contact {
+				float roll = 0.0f;
+				float bump = 0.0f;
+			} contact;
 
-					float wheel_roll_mul = (2.0f - event.relative_velocity.length()) * my_motion.velocity.length() / (4.0f * max_speed);
-					if (wheel_roll_mul > 0) {
-						wheel_roll_mul = std::clamp(wheel_roll_mul, 0.0f, 1.0f);
-						if (wheel_roll_sound.completion_rate() > 0.9f) {
-							wheel_roll_sound = audio.play_sound("wheel_roll", body_pos.value, {}, wheel_roll_mul);
-							wheel_roll_sound.set_tempo_shift(1.0f + (wheel_roll_mul - 0.5f) * 0.5f);
-						}
-					}
+			for (auto part_id : { engine_wheel_id, break_wheel_id, head_id, bike_body_id }) {
+				if (!ecs.exists(part_id)) {
+					continue;
+				}
 
-					float wheel_collision_mul = event.relative_velocity.length();
-					if (wheel_collision_mul > 100) {
-						if (wheel_crash_sound.completion_rate() > 0.1f) {
-							wheel_crash_sound = audio.play_sound("wheel_bump", body_pos.value, {}, std::clamp(wheel_collision_mul / 100.0f - 0.9f, 0.0f, 1.2f));
-						}
-					}
+				auto part = ecs[part_id];
+				const auto* collisions = part.try_get<const rynx::components::collision_custom_reaction>();
+				const auto* my_motion = part.try_get<const rynx::components::motion>();
+				if (!collisions || !my_motion) {
+					continue;
 				}
-			});
+
+				for (auto&& event : collisions->events) {
+					float wheel_roll_mul = (2.0f - event.relative_velocity.length()) * my_motion->velocity.length() / (4.0f * max_speed);
+					contact.roll = std::max(contact.roll, wheel_roll_mul);
+					contact.bump = std::max(contact.bump, event.relative_velocity.length());
+				}
+			}
+
+			if (contact.roll > 0) {
+				float wheel_roll_mul = std::clamp(contact.roll, 0.0f, 1.0f);
+				if (wheel_roll_sound.completion_rate() > 0.9f) {
+					wheel_roll_sound = audio.play_sound("wheel_roll", body_pos.value, {}, wheel_roll_mul);
+					wheel_roll_sound.set_tempo_shift(1.0f + (wheel_roll_mul - 0.5f) * 0.5f);
+				}
+			}
+
+			float wheel_collision_mul = contact.bump;
+			if (wheel_collision_mul > 100) {
+				if (wheel_crash_sound.completion_rate() > 0.1f) {
+					wheel_crash_sound = audio.play_sound("wheel_bump", body_pos.value, {}, std::clamp(wheel_collision_mul / 100.0f - 0.9f, 0.0f, 1.2f));
+				}
+			}
 
 			auto& emitter = entity.get<rynx::components::particle_emitter>();
 			emitter.spawn_rate = {200 * engine_activity_slide + 10, 500 * engine_activity_slide + 20 };
@@ -120,7 +133,7 @@ void game::hero_control::onFrameProcess(rynx::scheduler::context& context, float
 			emitter.initial_velocity = {40.0f * (1.0f + engine_acceleration_state), 80.0f * ( 1.0f + engine_acceleration_state) };
 		}
 
-		if (input.isKeyClicked(key_construct)) {
+		if (edges.clicked(edge_construct)) {
 			rynx::vec3f pos;
 
 			auto reset_entity_to = [&](rynx::ecs::id entity_id, rynx::vec3f local_offset)
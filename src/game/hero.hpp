@@ -5,6 +5,7 @@
 #include <rynx/math/vector.hpp>
 #include <rynx/audio/audio.hpp>
 #include <rynx/input/key_types.hpp>
+#include <game/frame_input.hpp>
 
 namespace game {
 	class hero_control : public rynx::application::logic::iruleset {
@@ -19,6 +20,8 @@ namespace game {
 		rynx::key::logical key_walk_right;
 		rynx::key::logical key_walk_back;
 
+		game::frame_input::edge_id edge_construct;
+
 		rynx::ecs::id engine_wheel_id;
 		rynx::ecs::id break_wheel_id;
 		rynx::ecs::id head_id;
@@ -41,6 +44,7 @@ namespace game {
 	public:
 		hero_control(
 			rynx::mapped_input& input,
+			game::frame_input& edges,
 			rynx::ecs::id back_wheel,
 			rynx::ecs::id front_wheel,
 			rynx::ecs::id head,
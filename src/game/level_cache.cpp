@@ -0,0 +1,355 @@
+
+#include <game/level_cache.hpp>
+#include <game/mapped_file.hpp>
+#include <game/height_field.hpp>
+#include <game/entity_builder.hpp>
+
+#include <rynx/tech/components.hpp>
+#include <rynx/application/components.hpp>
+#include <rynx/tech/profiling.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace {
+	constexpr uint32_t level_magic = 0x4c564c52; // "RLVL"
+	constexpr uint32_t level_version = 1;
+
+	enum entity_flags : uint32_t {
+		has_mesh = 1 << 0,
+		has_height_field = 1 << 1,
+		has_dampening = 1 << 2,
+		has_ignore_gravity = 1 << 3,
+	};
+
+	// saved entities never move. files written before static bodies had exact zero inverses still carry 1 / float max.
+	rynx::components::physical_body as_static_body(rynx::components::physical_body body) {
+		body.inv_mass = 0.0f;
+		body.inv_moment_of_inertia = 0.0f;
+		return body;
+	}
+
+	struct file_header {
+		uint32_t magic;
+		uint32_t version;
+		uint32_t entity_record_size;
+		uint32_t mesh_record_size;
+		
+		uint32_t num_entities;
+		uint32_t num_meshes;
+		uint32_t num_floats;
+		uint32_t num_indices;
+
+		uint64_t entities_offset;
+		uint64_t meshes_offset;
+		uint64_t floats_offset;
+		uint64_t indices_offset;
+	};
+
+	struct entity_record {
+		uint32_t flags;
+		int32_t mesh_index;
+		
+		uint32_t boundary_first; // offset of boundary vertices in float pool, three floats per vertex.
+		uint32_t boundary_count;
+		uint32_t heights_first;
+		uint32_t heights_count;
+		float height_field_x_begin;
+		float height_field_spacing;
+
+		rynx::components::position position;
+		rynx::components::radius radius;
+		rynx::components::color color;
+		rynx::components::collisions collisions;
+		rynx::components::physical_body body;
+		rynx::components::dampening dampening;
+	};
+
+	struct mesh_record {
+		uint32_t vertices_first;
+		uint32_t vertices_count;
+		uint32_t normals_first;
+		uint32_t normals_count;
+		uint32_t texcoords_first;
+		uint32_t texcoords_count;
+		uint32_t indices_first;
+		uint32_t indices_count;
+	};
+
+	static_assert(std::is_trivially_copyable_v<entity_record>, "level entity records are written as raw bytes");
+	static_assert(std::is_trivially_copyable_v<mesh_record>, "level mesh records are written as raw bytes");
+
+	constexpr uint64_t section_alignment = 64;
+	uint64_t align_section(uint64_t offset) {
+		return (offset + section_alignment - 1) & ~(section_alignment - 1);
+	}
+
+	// [offset, offset + count * sizeof(T)) is inside the file and aligned for T.
+	template<typename T>
+	bool valid_section(uint64_t offset, uint32_t count, size_t file_size) {
+		return offset <= file_size &&
+			offset % alignof(T) == 0 &&
+			uint64_t(count) * sizeof(T) <= file_size - offset;
+	}
+
+	bool valid_range(uint32_t first, uint64_t count, uint32_t pool_size) {
+		return uint64_t(first) + count <= pool_size;
+	}
+
+	bool valid_mesh(const mesh_record& record, const file_header& header, const uint16_t* indices) {
+		if (!valid_range(record.vertices_first, record.vertices_count, header.num_floats) ||
+			!valid_range(record.normals_first, record.normals_count, header.num_floats) ||
+			!valid_range(record.texcoords_first, record.texcoords_count, header.num_floats) ||
+			!valid_range(record.indices_first, record.indices_count, header.num_indices))
+		{
+			return false;
+		}
+
+		// indices go to the gpu as is, and rynx meshes store them as 16 bit signed values.
+		const uint32_t num_vertices = std::min<uint32_t>(record.vertices_count / 3, 32768);
+		return std::all_of(indices + record.indices_first, indices + record.indices_first + record.indices_count, [num_vertices](uint16_t index) {
+			return index < num_vertices;
+		});
+	}
+
+	bool valid_entity(const entity_record& record, const file_header& header) {
+		if (!valid_range(record.boundary_first, uint64_t(record.boundary_count) * 3, header.num_floats)) {
+			return false;
+		}
+		if ((record.flags & has_height_field) && !valid_range(record.heights_first, record.heights_count, header.num_floats)) {
+			return false;
+		}
+		if ((record.flags & has_mesh) && (record.mesh_index < 0 || uint32_t(record.mesh_index) >= header.num_meshes)) {
+			return false;
+		}
+		return true;
+	}
+
+	template<typename T>
+	uint32_t append(std::vector<T>& pool, const T* data, size_t count) {
+		uint32_t first = static_cast<uint32_t>(pool.size());
+		pool.insert(pool.end(), data, data + count);
+		return first;
+	}
+}
+
+bool game::save_level(const std::string& path, rynx::ecs& ecs, rynx::collision_detection::category_id category) {
+	rynx_profile("Game", "save level");
+
+	std::vector<entity_record> entities;
+	std::vector<mesh_record> meshes;
+	std::vector<float> floats;
+	std::vector<uint16_t> indices;
+
+	ecs.query().notIn<rynx::components::motion>().for_each([&](
+		rynx::ecs::id id,
+		const rynx::components::position& pos,
+		const rynx::components::radius& radius,
+		const rynx::components::color& color,
+		const rynx::components::collisions& collisions,
+		const rynx::components::boundary& boundary,
+		const rynx::components::physical_body& body)
+	{
+		if (collisions.category != category.value) {
+			return;
+		}
+
+		entity_record record{};
+		record.mesh_index = -1;
+		record.position = pos;
+		record.radius = radius;
+		record.color = color;
+		record.collisions = collisions;
+		record.body = body;
+
+		record.boundary_first = static_cast<uint32_t>(floats.size());
+		record.boundary_count = static_cast<uint32_t>(boundary.segments_local.size());
+		for (int32_t i = 0; i < boundary.segments_local.size(); ++i) {
+			auto v = boundary.segments_local.vertex_position(i);
+			floats.emplace_back(v.x);
+			floats.emplace_back(v.y);
+			floats.emplace_back(v.z);
+		}
+
+		auto entity = ecs[id];
+		if (const auto* damp = entity.try_get<rynx::components::dampening>()) {
+			record.flags |= has_dampening;
+			record.dampening = *damp;
+		}
+
+		if (entity.has<rynx::components::ignore_gravity>()) {
+			record.flags |= has_ignore_gravity;
+		}
+
+		if (const auto* field = entity.try_get<game::components::height_field>()) {
+			record.flags |= has_height_field;
+			record.height_field_x_begin = field->x_begin;
+			record.height_field_spacing = field->spacing;
+			record.heights_count = static_cast<uint32_t>(field->heights.size());
+			record.heights_first = append(floats, field->heights.data(), field->heights.size());
+		}
+
+		if (const auto* mesh = entity.try_get<rynx::components::mesh>(); mesh && mesh->m) {
+			record.flags |= has_mesh;
+			record.mesh_index = static_cast<int32_t>(meshes.size());
+
+			const auto& source = *mesh->m;
+			mesh_record m;
+			m.vertices_count = static_cast<uint32_t>(source.vertices.size());
+			m.vertices_first = append(floats, source.vertices.data(), source.vertices.size());
+			m.normals_count = static_cast<uint32_t>(source.normals.size());
+			m.normals_first = append(floats, source.normals.data(), source.normals.size());
+			m.texcoords_count = static_cast<uint32_t>(source.texCoords.size());
+			m.texcoords_first = append(floats, source.texCoords.data(), source.texCoords.size());
+			m.indices_first = static_cast<uint32_t>(indices.size());
+			m.indices_count = static_cast<uint32_t>(source.indices.size());
+			for (auto index : source.indices) {
+				indices.emplace_back(static_cast<uint16_t>(index));
+			}
+			meshes.emplace_back(m);
+		}
+
+		entities.emplace_back(record);
+	});
+
+	file_header header{};
+	header.magic = level_magic;
+	header.version = level_version;
+	header.entity_record_size = sizeof(entity_record);
+	header.mesh_record_size = sizeof(mesh_record);
+	header.num_entities = static_cast<uint32_t>(entities.size());
+	header.num_meshes = static_cast<uint32_t>(meshes.size());
+	header.num_floats = static_cast<uint32_t>(floats.size());
+	header.num_indices = static_cast<uint32_t>(indices.size());
+	header.entities_offset = align_section(sizeof(file_header));
+	header.meshes_offset = align_section(header.entities_offset + entities.size() * sizeof(entity_record));
+	header.floats_offset = align_section(header.meshes_offset + meshes.size() * sizeof(mesh_record));
+	header.indices_offset = align_section(header.floats_offset + floats.size() * sizeof(float));
+
+	std::error_code error;
+	std::filesystem::path file_path(path);
+	if (file_path.has_parent_path()) {
+		std::filesystem::create_directories(file_path.parent_path(), error);
+	}
+
+	std::ofstream out(path, std::ios::binary | std::ios::trunc);
+	if (!out) {
+		return false;
+	}
+
+	auto write_section = [&out](uint64_t offset, const void* data, size_t bytes) {
+		static const char zeros[section_alignment] = {};
+		uint64_t position = static_cast<uint64_t>(out.tellp());
+		out.write(zeros, static_cast<std::streamsize>(offset - position));
+		out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+	};
+
+	out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	write_section(header.entities_offset, entities.data(), entities.size() * sizeof(entity_record));
+	write_section(header.meshes_offset, meshes.data(), meshes.size() * sizeof(mesh_record));
+	write_section(header.floats_offset, floats.data(), floats.size() * sizeof(float));
+	write_section(header.indices_offset, indices.data(), indices.size() * sizeof(uint16_t));
+	return static_cast<bool>(out);
+}
+
+int32_t game::load_level(const std::string& path, rynx::ecs& ecs, rynx::graphics::mesh_collection& meshes, const std::string& texture) {
+	rynx_profile("Game", "load level");
+
+	game::mapped_file file(path);
+	if (!file.is_open() || file.size() < sizeof(file_header)) {
+		return -1;
+	}
+
+	const auto& header = *reinterpret_cast<const file_header*>(file.data());
+	if (header.magic != level_magic ||
+		header.version != level_version ||
+		header.entity_record_size != sizeof(entity_record) ||
+		header.mesh_record_size != sizeof(mesh_record) ||
+		!valid_section<entity_record>(header.entities_offset, header.num_entities, file.size()) ||
+		!valid_section<mesh_record>(header.meshes_offset, header.num_meshes, file.size()) ||
+		!valid_section<float>(header.floats_offset, header.num_floats, file.size()) ||
+		!valid_section<uint16_t>(header.indices_offset, header.num_indices, file.size()))
+	{
+		return -1;
+	}
+
+	const auto* entities = reinterpret_cast<const entity_record*>(file.data() + header.entities_offset);
+	const auto* mesh_records = reinterpret_cast<const mesh_record*>(file.data() + header.meshes_offset);
+	const auto* floats = reinterpret_cast<const float*>(file.data() + header.floats_offset);
+	const auto* indices = reinterpret_cast<const uint16_t*>(file.data() + header.indices_offset);
+
+	// everything is checked before anything is created, a truncated or corrupt file loads nothing.
+	const bool records_valid =
+		std::all_of(mesh_records, mesh_records + header.num_meshes, [&](const mesh_record& record) { return valid_mesh(record, header, indices); }) &&
+		std::all_of(entities, entities + header.num_entities, [&](const entity_record& record) { return valid_entity(record, header); });
+	if (!records_valid) {
+		return -1;
+	}
+
+	std::vector<rynx::graphics::mesh*> loaded_meshes(header.num_meshes);
+	for (uint32_t i = 0; i < header.num_meshes; ++i) {
+		const auto& record = mesh_records[i];
+		auto m = std::make_unique<rynx::graphics::mesh>();
+		m->vertices.assign(floats + record.vertices_first, floats + record.vertices_first + record.vertices_count);
+		m->normals.assign(floats + record.normals_first, floats + record.normals_first + record.normals_count);
+		m->texCoords.assign(floats + record.texcoords_first, floats + record.texcoords_first + record.texcoords_count);
+		m->indices.assign(indices + record.indices_first, indices + record.indices_first + record.indices_count);
+		loaded_meshes[i] = meshes.create(path + "_mesh_" + std::to_string(i), std::move(m), texture);
+	}
+
+	std::vector<rynx::vec3f> vertices;
+	for (uint32_t i = 0; i < header.num_entities; ++i) {
+		const auto& record = entities[i];
+		
+		const float* boundary_data = floats + record.boundary_first;
+		vertices.resize(record.boundary_count);
+		for (uint32_t k = 0; k < record.boundary_count; ++k) {
+			vertices[k] = rynx::vec3f(boundary_data[3 * k + 0], boundary_data[3 * k + 1], boundary_data[3 * k + 2]);
+		}
+
+		std::optional<rynx::components::dampening> dampening;
+		if (record.flags & has_dampening) {
+			dampening = rynx::components::dampening(record.dampening);
+		}
+
+		std::optional<rynx::components::ignore_gravity> ignore_gravity;
+		if (record.flags & has_ignore_gravity) {
+			ignore_gravity = rynx::components::ignore_gravity();
+		}
+
+		std::optional<game::components::height_field> field;
+		if (record.flags & has_height_field) {
+			field.emplace();
+			field->x_begin = record.height_field_x_begin;
+			field->spacing = record.height_field_spacing;
+			field->heights.assign(floats + record.heights_first, floats + record.heights_first + record.heights_count);
+		}
+
+		std::optional<std::tuple<rynx::components::mesh, rynx::matrix4>> mesh;
+		if (record.flags & has_mesh) {
+			mesh.emplace(rynx::components::mesh(loaded_meshes[record.mesh_index]), rynx::matrix4());
+		}
+
+		game::create_entity(ecs,
+			std::make_tuple(
+				rynx::components::position(record.position),
+				rynx::components::radius(record.radius),
+				rynx::components::color(record.color),
+				rynx::components::collisions(record.collisions),
+				rynx::components::boundary(rynx::polygon(vertices), record.position.value, record.position.angle),
+				as_static_body(record.body)
+			),
+			std::move(dampening),
+			std::move(ignore_gravity),
+			std::move(field),
+			std::move(mesh)
+		);
+	}
+
+	return static_cast<int32_t>(header.num_entities);
+}
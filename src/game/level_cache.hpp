@@ -0,0 +1,20 @@
+#pragma once
+
+#include <rynx/tech/ecs.hpp>
+#include <rynx/tech/collision_detection.hpp>
+#include <rynx/graphics/renderer/meshrenderer.hpp>
+
+#include <string>
+
+namespace game {
+	// level files are flat arrays of fixed size records followed by shared float and index pools.
+	// loading maps the file and copies the records straight to ecs components and meshes, nothing is parsed.
+	// component records are stored as raw bytes, so a file is only valid for the build that wrote it.
+	// a file from another build is rejected and the level is expected to be rebuilt.
+
+	// writes every non-moving entity with a boundary in the given collision category.
+	bool save_level(const std::string& path, rynx::ecs& ecs, rynx::collision_detection::category_id category);
+	
+	// returns the number of entities created, or -1 if the file is missing, from an incompatible build, truncated or corrupt.
+	int32_t load_level(const std::string& path, rynx::ecs& ecs, rynx::graphics::mesh_collection& meshes, const std::string& texture);
+}
@@ -21,10 +21,10 @@
 
 #include <rynx/rulesets/frustum_culling.hpp>
 #include <rynx/rulesets/motion.hpp>
-#include <rynx/rulesets/physics/springs.hpp>
 #include <rynx/rulesets/collisions.hpp>
 #include <rynx/rulesets/particles.hpp>
 #include <rynx/rulesets/lifetime.hpp>
+#include <rynx/rulesets/physics/springs.hpp>
 
 #include <rynx/tech/smooth_value.hpp>
 #include <rynx/tech/timer.hpp>
@@ -52,27 +52,18 @@
 
 #include <rynx/math/spline.hpp>
 
-#include <game/terrain.hpp>
+#include <game/terrain_streaming.hpp>
+#include <game/height_field_collisions.hpp>
+#include <game/suspension_tracking.hpp>
 #include <game/bike_creation.hpp>
-
-void attach_fire_to(rynx::ecs& ecs, rynx::ecs::id id) {
-	rynx::components::particle_emitter emitter;
-	emitter.edit().color_ranges(
-		{ rynx::floats4{0.5f, 0.3f, 0.0f, 0.3f}, rynx::floats4{0.6f, 0.4f, 0.0f, 0.3f} },
-		{ rynx::floats4{1.0f, 0.3f, 0.0f, 0.0f}, rynx::floats4{1.0f, 0.6f, 0.1f, 0.0f} }
-	).radius_ranges(	
-		{ 4.0f, 7.5f },
-		{ 0.0f, 0.1f }
-	).lifetime_range({ 0.6f, 1.2f })
-		.linear_dampening_range({ 0.3f, 0.6f })
-		.spawn_rate_range({ 50.0f, 100.0f })
-		.initial_velocity_range({ 100.0f, 300.0f })
-		.initial_angle_range({0.0f, 1.0f})
-		.rotate_with_host(true)
-		.position_offset({0, -10, 0});
-
-	ecs.attachToEntity(id, emitter);
-}
+#include <game/level_cache.hpp>
+#include <game/replay.hpp>
+#include <game/fixed_timestep.hpp>
+#include <game/position_interpolation.hpp>
+#include <game/transform_changes.hpp>
+#include <game/ecs_commands.hpp>
+#include <game/frame_input.hpp>
+#include <game/camera_requests.hpp>
 
 int main(int argc, char** argv) {
 
@@ -174,16 +165,24 @@ int main(int argc, char** argv) {
 	*/
 
 	game_collisions gameCollisionsSetup(*detection);
+	game::ecs_commands ecs_commands;
+	game::frame_input frame_input;
+	game::camera_requests camera_requests;
+	game::transform_changes transform_changes;
 	
 	{
 		base_simulation.set_resource(detection.get());
+		base_simulation.set_resource(&ecs_commands);
 		base_simulation.set_resource(&gameInput);
+		base_simulation.set_resource(&frame_input);
+		base_simulation.set_resource(&camera_requests);
+		base_simulation.set_resource(&transform_changes);
 		base_simulation.set_resource(&audio);
 		base_simulation.set_resource(camera.get());
 		base_simulation.set_resource(&type_reflections);
 	}
 	
-	const auto [back_wheel_id, front_wheel_id, head_id, bike_body_id, hand_joint_id] = game::construct_player(ecs, *application.textures(), gameCollisionsSetup.category_dynamic(), *meshes, { -100, 0, 0 });
+	const auto [back_wheel_id, front_wheel_id, head_id, bike_body_id, hand_joint_id] = game::construct_player(ecs, *application.textures(), gameCollisionsSetup.category_dynamic(), gameCollisionsSetup.category_wheels(), *meshes, { -100, 0, 0 });
 	
 	std::cerr << "back wheel id: " << back_wheel_id << std::endl;
 	std::cerr << "front wheel id: " << front_wheel_id << std::endl;
@@ -202,18 +201,31 @@ int main(int argc, char** argv) {
 	}
 
 
+	const std::string level_path = "../levels/default.level";
+	std::cerr << "level entities loaded: " << game::load_level(level_path, ecs, *meshes, "Empty") << std::endl;
+
+	// race against the previous run.
+	const std::string replay_path = "../replays/last.replay";
+	game::replay_track ghost_track;
+	const bool has_ghost = ghost_track.load(replay_path);
+	std::shared_ptr<game::replay_recorder> ruleset_replay_recorder;
+	std::shared_ptr<game::terrain_streaming> ruleset_terrain_streaming;
+
 	auto editor_top = std::make_shared<rynx::menu::Div>(rynx::vec3f{ 1.0f, 1.0f, 0.0f });
 	menu.add_child(editor_top);
 
 	// setup game logic
 	{
-		auto ruleset_hero_inputs = base_simulation.rule_set(state_id_user_controls).create<game::hero_control>(gameInput, back_wheel_id, front_wheel_id, head_id, bike_body_id, hand_joint_id);
+		auto ruleset_hero_inputs = base_simulation.rule_set(state_id_user_controls).create<game::hero_control>(gameInput, frame_input, back_wheel_id, front_wheel_id, head_id, bike_body_id, hand_joint_id);
 		auto ruleset_collisionDetection = base_simulation.rule_set(state_id_physics).create<rynx::ruleset::physics_2d>();
+		auto ruleset_height_field_collisions = base_simulation.rule_set(state_id_physics).create<game::height_field_collisions>();
 		auto ruleset_motion_updates = base_simulation.rule_set(state_id_physics).create<rynx::ruleset::motion_updates>(rynx::vec3<float>(0, -160.8f, 0));
 		auto ruleset_physical_springs = base_simulation.rule_set(state_id_physics).create<rynx::ruleset::physics::springs>();
+		auto ruleset_suspension_tracking = base_simulation.rule_set(state_id_physics).create<game::suspension_tracking>();
 		auto ruleset_lifetime_updates = base_simulation.rule_set(state_id_physics).create<rynx::ruleset::lifetime_updates>();
 		auto ruleset_particle_update = base_simulation.rule_set(state_id_physics).create<rynx::ruleset::particle_system>();
 		auto ruleset_frustum_culling = base_simulation.rule_set(state_id_update_frustum_culling).create<rynx::ruleset::frustum_culling>(camera);
+		ruleset_terrain_streaming = base_simulation.rule_set().create<game::terrain_streaming>(*meshes, *application.textures(), "Empty", gameCollisionsSetup.category_terrain());
 		auto ruleset_editor_rules = base_simulation.rule_set(editorstate)
 			.create<editor_rules>(
 				*base_simulation.m_context,
@@ -225,12 +237,23 @@ int main(int argc, char** argv) {
 				gameCollisionsSetup.category_dynamic(),
 				gameCollisionsSetup.category_static(),
 				gamestate,
-				editorstate
+				editorstate,
+				level_path
 			);
-		auto ruleset_debug_input = base_simulation.rule_set().create<debug_input>(gameInput, gamestate, editorstate, state_id_update_frustum_culling);
+		auto ruleset_debug_input = base_simulation.rule_set().create<debug_input>(gameInput, frame_input, gamestate, editorstate, state_id_update_frustum_culling);
+		
+		ruleset_replay_recorder = base_simulation.rule_set(state_id_physics).create<game::replay_recorder>(game::bike_instance{ back_wheel_id, front_wheel_id, head_id, bike_body_id, hand_joint_id });
+		ruleset_replay_recorder->depends_on(ruleset_physical_springs);
+		ruleset_replay_recorder->depends_on(ruleset_height_field_collisions);
+
+		if (has_ghost) {
+			base_simulation.rule_set(state_id_physics).create<game::replay_player>(std::move(ghost_track), *meshes);
+		}
 
 		ruleset_physical_springs->depends_on(ruleset_motion_updates);
+		ruleset_suspension_tracking->depends_on(ruleset_physical_springs);
 		ruleset_collisionDetection->depends_on(ruleset_motion_updates);
+		ruleset_height_field_collisions->depends_on(ruleset_collisionDetection);
 		ruleset_frustum_culling->depends_on(ruleset_motion_updates);
 		ruleset_hero_inputs->depends_on(ruleset_motion_updates);
 	}
@@ -258,9 +281,11 @@ int main(int argc, char** argv) {
 	rynx::sound::configuration music;
 	rynx::timer frame_timer_dt;
 	float dt = 1.0f / 120.0f;
-	
-	std::cerr << "Terrain id: " << game::create_terrain(base_simulation.m_ecs, *meshes, *application.textures(), "Empty", gameCollisionsSetup.category_static()).value;
 
+	// logic runs at a steady rate, rendering happens once per frame between the last two logic states.
+	game::fixed_timestep logic_timestep(1.0f / 120.0f);
+	game::position_interpolation interpolation;
+	
 	auto marker_id = ecs.create(
 		rynx::components::position({0.0f, -55.0f, 0.0f}, 0),
 		rynx::components::radius(30.0f),
@@ -297,6 +322,34 @@ int main(int argc, char** argv) {
 	rynx::numeric_property<float> logic_fps;
 	rynx::numeric_property<float> render_fps;
 
+	const float tick_dt = logic_timestep.tick_length();
+	auto begin_logic_tick = [&]() {
+		frame_input.begin_tick();
+		base_simulation.generate_tasks(tick_dt);
+		scheduler.start_frame();
+	};
+
+	auto end_logic_tick = [&]() {
+		{
+			rynx_profile("Main", "Wait for frame end");
+			scheduler.wait_until_complete();
+		}
+
+		// drawing is done with the camera by now, apply the moves logic asked for.
+		camera_requests.apply(*camera);
+
+		float length_of_current = (path_points[int32_t(path_point) % path_points.size()] - path_points[(int32_t(path_point) + 1) % path_points.size()]).length();
+
+		path_point += 100.0f * tick_dt / length_of_current;
+		ecs[marker_id].get<rynx::components::position>().value =
+			path_points[int32_t(path_point) % path_points.size()] * (1.0f - (path_point - int32_t(path_point))) +
+			path_points[(int32_t(path_point) + 1) % path_points.size()] * (path_point - int32_t(path_point));
+
+		// creates, erases and dead entities from this tick.
+		ecs_commands.apply(ecs, *detection, base_simulation.m_logic, *base_simulation.m_context);
+		transform_changes.end_tick(ecs);
+	};
+
 	while (!application.isExitRequested()) {
 		rynx_profile("Main", "frame");
 		
@@ -339,45 +392,38 @@ int main(int argc, char** argv) {
 		//       game takes a look at input state.
 		menu.logic_tick(dt, application.aspectRatio(), gameInput);
 
+		// render snapshot. preparation copies transforms, meshes, colors, lights and particles
+		// out of the ecs into the renderer's own buffers, after which drawing does not touch the ecs.
 		{
-			rynx_profile("Main", "Wait for frame end");
-			base_simulation.generate_tasks(dt);
-			auto input_inhibited_scope = menu.inhibit_dedicated_inputs(gameInput);
+			rynx_profile("Main", "prepare");
+			render_fps.observe_value(1.0f / dt);
+			
+			interpolation.apply(ecs, transform_changes, logic_timestep.alpha());
+			render.prepare(base_simulation.m_context);
 			scheduler.start_frame();
-			scheduler.wait_until_complete();
-		}
 
-		float length_of_current = (path_points[int32_t(path_point) % path_points.size()] - path_points[(int32_t(path_point) + 1) % path_points.size()]).length();
+			// while waiting for computing to be completed, draw menus.
+			application.renderer().setDepthTest(false);
+			menu.graphics_tick(application.aspectRatio(), application.renderer());
 
-		path_point += 100.0f * dt / length_of_current;
-		ecs[marker_id].get<rynx::components::position>().value =
-			path_points[int32_t(path_point) % path_points.size()] * (1.0f - (path_point - int32_t(path_point))) +
-			path_points[(int32_t(path_point) + 1) % path_points.size()] * (path_point - int32_t(path_point));
+			scheduler.wait_until_complete();
+			interpolation.restore(ecs);
+			
+			// TODO: debug visualisations should be drawn on their own fbo?
+			application.debugVis()->prepare(base_simulation.m_context);
+		}
 
-		// should we render or not.
-		static float time_since_prev_rendered_frame = 1.0f;
-		constexpr float target_fps = 120.0f;
+		// the first logic tick of this frame runs on the workers while this thread submits the snapshot to the gpu.
+		const int32_t logic_ticks = logic_timestep.advance(dt);
+		auto input_inhibited_scope = menu.inhibit_dedicated_inputs(gameInput);
+		frame_input.collect(gameInput);
+		if (logic_ticks > 0) {
+			begin_logic_tick();
+		}
 
-		time_since_prev_rendered_frame += dt;
-		if(time_since_prev_rendered_frame > 1.0f / target_fps)
 		{
-			render_fps.observe_value(1.0f / time_since_prev_rendered_frame);
-			time_since_prev_rendered_frame = 0.0f;
-
 			rynx_profile("Main", "graphics");
 
-			{
-				rynx_profile("Main", "prepare");
-				render.prepare(base_simulation.m_context);
-				scheduler.start_frame();
-
-				// while waiting for computing to be completed, draw menus.
-				application.renderer().setDepthTest(false);
-				menu.graphics_tick(application.aspectRatio(), application.renderer());
-
-				scheduler.wait_until_complete();
-			}
-
 			{
 				rynx_profile("Main", "draw");
 				
@@ -438,7 +484,6 @@ int main(int argc, char** argv) {
 				render.execute();
 
 				// TODO: debug visualisations should be drawn on their own fbo?
-				application.debugVis()->prepare(base_simulation.m_context);
 				application.debugVis()->execute();
 				
 				{
@@ -449,24 +494,21 @@ int main(int argc, char** argv) {
 			}
 		}
 
-		{
-			rynx_profile("Main", "Clean up dead entitites");
-			auto ids_dead = ecs.query().in<rynx::components::dead>().ids();
-			for (auto id : ids_dead) {
-				if (ecs[id].has<rynx::components::collisions>()) {
-					auto collisions = ecs[id].get<rynx::components::collisions>();
-					detection->erase(ecs, id.value, collisions.category);
-				}
+		for (int32_t tick = 0; tick < logic_ticks; ++tick) {
+			if (tick > 0) {
+				begin_logic_tick();
 			}
-
-			base_simulation.m_logic.entities_erased(*base_simulation.m_context, ids_dead);
-			ecs.erase(ids_dead);
+			end_logic_tick();
 		}
 
-		// update dt for next frame.
-		dt = std::min(0.016f, std::max(0.0001f, frame_timer_dt.time_since_last_access_seconds_float()));
-		logic_fps.observe_value(1.0f / dt);
+		// everything drawn this frame has been submitted, chunks recycled by the ticks above can be refilled.
+		ruleset_terrain_streaming->upload_meshes();
+
+		// update dt for next frame. long stalls are capped, the fixed timestep drops what it can not catch up with anyway.
+		dt = std::min(0.25f, std::max(0.0001f, frame_timer_dt.time_since_last_access_seconds_float()));
+		logic_fps.observe_value(logic_ticks / dt);
 	}
 
+	ruleset_replay_recorder->track().save(replay_path);
 	return 0;
 }
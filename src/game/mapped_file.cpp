@@ -0,0 +1,95 @@
+
+#include <game/mapped_file.hpp>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+bool game::mapped_file::open(const std::string& path) {
+	close();
+
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+
+	LARGE_INTEGER file_size;
+	if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping) {
+		CloseHandle(file);
+		return false;
+	}
+
+	void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!view) {
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	m_file = file;
+	m_mapping = mapping;
+	m_data = static_cast<const uint8_t*>(view);
+	m_size = static_cast<size_t>(file_size.QuadPart);
+	return true;
+}
+
+void game::mapped_file::close() {
+	if (m_data) {
+		UnmapViewOfFile(m_data);
+		CloseHandle(m_mapping);
+		CloseHandle(m_file);
+	}
+	m_data = nullptr;
+	m_mapping = nullptr;
+	m_file = nullptr;
+	m_size = 0;
+}
+#else
+bool game::mapped_file::open(const std::string& path) {
+	close();
+
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return false;
+	}
+
+	struct stat file_info;
+	if (fstat(fd, &file_info) != 0 || file_info.st_size == 0) {
+		::close(fd);
+		return false;
+	}
+
+	void* view = mmap(nullptr, static_cast<size_t>(file_info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd); // mapping stays valid after the descriptor is closed.
+	
+	if (view == MAP_FAILED) {
+		return false;
+	}
+
+	m_data = static_cast<const uint8_t*>(view);
+	m_size = static_cast<size_t>(file_info.st_size);
+	return true;
+}
+
+void game::mapped_file::close() {
+	if (m_data) {
+		munmap(const_cast<uint8_t*>(m_data), m_size);
+	}
+	m_data = nullptr;
+	m_size = 0;
+}
+#endif
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace game {
+	// read only memory mapping of a whole file.
+	class mapped_file {
+	public:
+		mapped_file() = default;
+		explicit mapped_file(const std::string& path) { open(path); }
+		~mapped_file() { close(); }
+
+		mapped_file(const mapped_file&) = delete;
+		mapped_file& operator = (const mapped_file&) = delete;
+
+		bool open(const std::string& path);
+		void close();
+
+		bool is_open() const { return m_data != nullptr; }
+		const uint8_t* data() const { return m_data; }
+		size_t size() const { return m_size; }
+
+	private:
+		const uint8_t* m_data = nullptr;
+		size_t m_size = 0;
+
+#ifdef _WIN32
+		void* m_file = nullptr;
+		void* m_mapping = nullptr;
+#endif
+	};
+}
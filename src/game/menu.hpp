@@ -22,6 +22,18 @@
 #include <rynx/math/geometry/plane.hpp>
 
 #include <editor/editor.hpp>
+#include <game/level_cache.hpp>
+#include <game/collision_categories.hpp>
+#include <game/ecs_commands.hpp>
+#include <game/frame_input.hpp>
+#include <game/camera_requests.hpp>
+#include <game/transform_changes.hpp>
+#include <game/parallel_reduce.hpp>
+#include <game/editor_shapes.hpp>
+#include <game/segment_grid.hpp>
+
+#include <unordered_map>
+#include <vector>
 
 class ieditor_tool {
 public:
@@ -36,6 +48,8 @@ namespace tools {
 		selection_tool(rynx::scheduler::context& ctx) {
 			auto& input = ctx.get_resource<rynx::mapped_input>();
 			m_activation_key = input.generateAndBindGameKey(input.getMouseKeyPhysical(0), "selection tool activate");
+			m_activation_edge = ctx.get_resource<game::frame_input>().track(m_activation_key);
+			m_changes = &ctx.get_resource<game::transform_changes>();
 		}
 
 		virtual void update(rynx::scheduler::context& ctx) override {
@@ -47,15 +61,17 @@ namespace tools {
 			ctx.add_task("editor tick", [this](
 				rynx::ecs& game_ecs,
 				rynx::mapped_input& gameInput,
-				rynx::camera& gameCamera)
+				const game::frame_input& edges,
+				rynx::camera& gameCamera,
+				rynx::scheduler::task& task_context)
 			{
-				if (gameInput.isKeyPressed(m_activation_key) && !gameInput.isKeyConsumed(m_activation_key)) {
+				if (edges.pressed(m_activation_edge) && !gameInput.isKeyConsumed(m_activation_key)) {
 					auto mouseRay = gameInput.mouseRay(gameCamera);
 					auto [mouse_z_plane, hit] = mouseRay.intersect(rynx::plane(0, 0, 1, 0));
 					mouse_z_plane.z = 0;
 
 					if (hit) {
-						on_key_press(game_ecs, mouse_z_plane);
+						on_key_press(game_ecs, task_context, mouse_z_plane);
 					}
 				}
 			});
@@ -65,6 +81,25 @@ namespace tools {
 			return m_selected_entity_id;
 		}
 
+		const game::segment_grid& boundary_grid(rynx::ecs& game_ecs, rynx::ecs::id id) {
+			auto entity = game_ecs[id];
+			const auto& boundary = entity.get<rynx::components::boundary>();
+			auto [it, created] = m_boundary_grids.try_emplace(id.value);
+			auto& cached = it->second;
+			
+			const bool moved = m_changes->changed_tick(id) > cached.built_tick;
+			if (created || moved || cached.segments != static_cast<int32_t>(boundary.segments_world.size())) {
+				cached.grid.build(boundary.segments_world);
+				cached.built_tick = m_changes->tick();
+				cached.segments = static_cast<int32_t>(boundary.segments_world.size());
+			}
+			return cached.grid;
+		}
+
+		void invalidate_boundary_grid(rynx::ecs::id id) {
+			m_boundary_grids.erase(id.value);
+		}
+
 		void on_entity_selected(std::function<void(rynx::ecs::id)> op) {
 			m_on_entity_selected = std::move(op);
 		}
@@ -76,32 +111,46 @@ namespace tools {
 		}
 
 	private:
-		void on_key_press(rynx::ecs& game_ecs, rynx::vec3f cursorWorldPos) {
-			float best_distance = 1e30f;
-			rynx::ecs::id best_id;
-
-			// find best selection
-			game_ecs.query().for_each([&, mouse_world_pos = cursorWorldPos](rynx::ecs::id id, rynx::components::position pos) {
-				float sqr_dist = (mouse_world_pos - pos.value).length_squared();
-				auto* ptr = game_ecs[id].try_get<rynx::components::boundary>();
-
-				if (sqr_dist < best_distance) {
-					best_distance = sqr_dist;
-					best_id = id;
-				}
+		void on_key_press(rynx::ecs& game_ecs, rynx::scheduler::task& task_context, rynx::vec3f cursorWorldPos) {
+			struct pick {
+				float distance = 1e30f;
+				rynx::ecs::id id;
+			};
+
+			// find best selection. chunks are combined in order and only a strictly closer pick wins,
+			// so the result is the same as scanning everything serially.
+			auto ids = game_ecs.query().in<rynx::components::position>().ids();
+			refresh_boundary_grids(game_ecs, ids);
+
+			constexpr size_t entities_per_task = 256;
+			pick best = game::parallel_reduce(task_context, ids.size(), entities_per_task, pick{},
+				[&, mouse_world_pos = cursorWorldPos](size_t begin, size_t end) {
+					pick chunk_best;
+					for (size_t k = begin; k < end; ++k) {
+						auto entity = game_ecs[ids[k]];
+						float sqr_dist = (mouse_world_pos - entity.get<rynx::components::position>().value).length_squared();
+						auto* ptr = entity.try_get<rynx::components::boundary>();
+
+						if (sqr_dist < chunk_best.distance) {
+							chunk_best = { sqr_dist, ids[k] };
+						}
 
-				if (ptr) {
-					for (size_t i = 0; i < ptr->segments_world.size(); ++i) {
-						// some threshold for vertex picking
-						const auto vertex = ptr->segments_world.segment(i);
-						auto [dist, shortest_pos] = rynx::math::pointDistanceLineSegmentSquared(vertex.p1, vertex.p2, mouse_world_pos);
-						if (dist < best_distance) {
-							best_distance = dist;
-							best_id = id;
+						if (ptr) {
+							const auto& grid = m_boundary_grids.find(ids[k].value)->second.grid;
+							auto [segment, dist] = grid.closest(mouse_world_pos, chunk_best.distance, [&](int32_t i) {
+								const auto vertex = ptr->segments_world.segment(i);
+								return rynx::math::pointDistanceLineSegmentSquared(vertex.p1, vertex.p2, mouse_world_pos).first;
+							});
+							if (segment >= 0) {
+								chunk_best = { dist, ids[k] };
+							}
 						}
 					}
-				}
-			});
+					return chunk_best;
+				},
+				[](pick a, pick b) { return (b.distance < a.distance) ? b : a; });
+
+			rynx::ecs::id best_id = best.id;
 
 			// unselect previous selection
 			if (game_ecs.exists(m_selected_entity_id)) {
@@ -129,11 +178,40 @@ namespace tools {
 			}
 		}
 
+		// stale grids are rebuilt before the parallel part of picking, which then only reads them.
+		void refresh_boundary_grids(rynx::ecs& game_ecs, const std::vector<rynx::ecs::id>& ids) {
+			for (auto& entry : m_boundary_grids) {
+				entry.second.seen = false;
+			}
+
+			for (auto id : ids) {
+				if (game_ecs[id].has<rynx::components::boundary>()) {
+					boundary_grid(game_ecs, id);
+					m_boundary_grids[id.value].seen = true;
+				}
+			}
+
+			std::erase_if(m_boundary_grids, [](const auto& entry) { return !entry.second.seen; });
+		}
+
+		// segment grids of world space boundaries. a grid is rebuilt when game::transform_changes has seen its entity
+		// move since the grid was built, or its segment count has changed. other edits, and moves made during the
+		// current tick, must call invalidate_boundary_grid.
+		struct cached_grid {
+			game::segment_grid grid;
+			uint64_t built_tick = 0;
+			int32_t segments = -1;
+			bool seen = false;
+		};
+
+		std::unordered_map<uint64_t, cached_grid> m_boundary_grids;
+		const game::transform_changes* m_changes = nullptr;
 		std::function<void()> m_run_on_main_thread;
 		std::function<void(rynx::ecs::id)> m_on_entity_selected;
 		rynx::ecs::id m_selected_entity_id;
 		rynx::floats4 m_selected_entity_original_color;
 		rynx::key::logical m_activation_key;
+		game::frame_input::edge_id m_activation_edge;
 	};
 
 
@@ -145,6 +223,12 @@ namespace tools {
 			m_secondary_activation_key = input.generateAndBindGameKey(input.getMouseKeyPhysical(1), "polygon tool activate");
 			m_key_smooth = input.generateAndBindGameKey(',', "polygon smooth op");
 			m_selection_tool = selection;
+
+			auto& edges = ctx.get_resource<game::frame_input>();
+			m_activation_edge = edges.track(m_activation_key);
+			m_secondary_activation_edge = edges.track(m_secondary_activation_key);
+			m_smooth_edge = edges.track(m_key_smooth);
+			m_changes = &ctx.get_resource<game::transform_changes>();
 		}
 
 		virtual void update(rynx::scheduler::context& ctx) override {
@@ -152,6 +236,7 @@ namespace tools {
 				rynx::ecs& game_ecs,
 				rynx::collision_detection& detection,
 				rynx::mapped_input& gameInput,
+				const game::frame_input& edges,
 				rynx::camera& gameCamera)
 				{
 					auto id = m_selection_tool->selected_entity();
@@ -162,7 +247,7 @@ namespace tools {
 							auto [mouse_z_plane, hit] = mouseRay.intersect(rynx::plane(0, 0, 1, 0));
 							mouse_z_plane.z = 0;
 
-							if (gameInput.isKeyPressed(m_activation_key)) {
+							if (edges.pressed(m_activation_edge)) {
 								if (hit) {
 									if (!vertex_create(game_ecs, mouse_z_plane)) {
 										m_selected_vertex = vertex_select(game_ecs, mouse_z_plane);
@@ -171,7 +256,7 @@ namespace tools {
 								}
 							}
 
-							if (gameInput.isKeyPressed(m_secondary_activation_key)) {
+							if (edges.pressed(m_secondary_activation_edge)) {
 								if (hit) {
 									int32_t vertex_index = vertex_select(game_ecs, mouse_z_plane);
 									if (vertex_index >= 0) {
@@ -180,6 +265,8 @@ namespace tools {
 										boundary.segments_local.edit().erase(vertex_index);
 										boundary.segments_world = boundary.segments_local;
 										boundary.update_world_positions(pos.value, pos.angle);
+										m_selection_tool->invalidate_boundary_grid(id);
+										m_changes->mark(id);
 									}
 								}
 							}
@@ -188,12 +275,12 @@ namespace tools {
 								drag_operation_update(game_ecs, mouse_z_plane);
 							}
 
-							if (gameInput.isKeyReleased(m_activation_key)) {
+							if (edges.released(m_activation_edge)) {
 								drag_operation_end(game_ecs, detection);
 							}
 
 							// smooth selected polygon
-							if (gameInput.isKeyClicked(m_key_smooth)) {
+							if (edges.clicked(m_smooth_edge)) {
 								auto& boundary = entity.get<rynx::components::boundary>();
 								boundary.segments_local.edit().smooth(3);
 								boundary.segments_local.recompute_normals();
@@ -201,6 +288,8 @@ namespace tools {
 
 								auto pos = entity.get<rynx::components::position>();
 								boundary.update_world_positions(pos.value, pos.angle);
+								m_selection_tool->invalidate_boundary_grid(id);
+								m_changes->mark(id);
 
 								// TODO: should really also update radius.
 							}
@@ -229,28 +318,25 @@ namespace tools {
 			auto pos = entity.get<rynx::components::position>();
 			auto& boundary = entity.get<rynx::components::boundary>();
 
-			for (size_t i = 0; i < boundary.segments_world.size(); ++i) {
-				// some threshold for vertex picking
+			// closest vertex or segment middle. a middle wins only when strictly closer than its segment's first vertex.
+			const auto& grid = m_selection_tool->boundary_grid(game_ecs, m_selection_tool->selected_entity());
+			auto [segment, distance] = grid.closest(cursorWorldPos, best_distance, [&](int32_t i) {
 				const auto vertex = boundary.segments_world.segment(i);
-				
-				if ((vertex.p1 - cursorWorldPos).length_squared() < best_distance) {
-					best_distance = (vertex.p1 - cursorWorldPos).length_squared();
-					best_vertex = int(i);
-					should_create = false;
-				}
+				return std::min((vertex.p1 - cursorWorldPos).length_squared(), ((vertex.p1 + vertex.p2) * 0.5f - cursorWorldPos).length_squared());
+			});
 
-				float segment_mid_dist = ((vertex.p1 + vertex.p2) * 0.5f - cursorWorldPos).length_squared();
-				if (segment_mid_dist < best_distance) {
-					best_distance = segment_mid_dist;
-					best_vertex = int(i);
-					should_create = true;
-				}
+			if (segment >= 0) {
+				const auto vertex = boundary.segments_world.segment(segment);
+				best_vertex = segment;
+				should_create = ((vertex.p1 + vertex.p2) * 0.5f - cursorWorldPos).length_squared() < (vertex.p1 - cursorWorldPos).length_squared();
 			}
 
 			if (should_create) {
 				boundary.segments_local.edit().insert(best_vertex, cursorWorldPos - pos.value);
 				boundary.segments_world = boundary.segments_local;
 				boundary.update_world_positions(pos.value, pos.angle);
+				m_selection_tool->invalidate_boundary_grid(m_selection_tool->selected_entity());
+				m_changes->mark(m_selection_tool->selected_entity());
 				m_selected_vertex = best_vertex + 1;
 			}
 
@@ -267,15 +353,11 @@ namespace tools {
 			auto pos = entity.get<rynx::components::position>();
 			const auto& boundary = entity.get<rynx::components::boundary>();
 	
-			for (size_t i = 0; i < boundary.segments_world.size(); ++i) {
-				// some threshold for vertex picking
-				const auto vertex = boundary.segments_world.segment(i);
-				float limit = (best_vertex == -1) ? 15.0f * 15.0f : best_distance;
-				if ((vertex.p1 - cursorWorldPos).length_squared() < limit) {
-					best_distance = (vertex.p1 - cursorWorldPos).length_squared();
-					best_vertex = int(i);
-				}
-			}
+			// some threshold for vertex picking
+			const auto& grid = m_selection_tool->boundary_grid(game_ecs, m_selection_tool->selected_entity());
+			best_vertex = grid.closest(cursorWorldPos, 15.0f * 15.0f, [&](int32_t i) {
+				return (boundary.segments_world.segment(i).p1 - cursorWorldPos).length_squared();
+			}).first;
 
 			return best_vertex;
 		}
@@ -305,9 +387,13 @@ namespace tools {
 
 					// todo: just update the edited parts
 					boundary.update_world_positions(entity_pos.value, entity_pos.angle);
+					m_selection_tool->invalidate_boundary_grid(m_selection_tool->selected_entity());
+					m_changes->mark(m_selection_tool->selected_entity());
 				}
 				else {
 					entity_pos.value = m_drag_action_object_origin + position_delta;
+					m_selection_tool->invalidate_boundary_grid(m_selection_tool->selected_entity());
+					m_changes->mark(m_selection_tool->selected_entity());
 				}
 			}
 		}
@@ -328,18 +414,25 @@ namespace tools {
 				entity.get<rynx::components::radius>().r = boundary.segments_local.radius();
 				boundary.update_world_positions(entity_pos.value, entity_pos.angle);
 				detection.update_entity_forced(game_ecs, entity.id());
+				m_selection_tool->invalidate_boundary_grid(entity.id());
+				m_changes->mark(entity.id());
 			}
 
 			m_drag_action_active = false;
 		}
 
 		selection_tool* m_selection_tool = nullptr;
+		const game::transform_changes* m_changes = nullptr;
 		int32_t m_selected_vertex = -1; // -1 is none, otherwise this is an index to polygon vertex array.
 		rynx::key::logical m_activation_key;
 		rynx::key::logical m_secondary_activation_key;
 
 		rynx::key::logical m_key_smooth;
 
+		game::frame_input::edge_id m_activation_edge;
+		game::frame_input::edge_id m_secondary_activation_edge;
+		game::frame_input::edge_id m_smooth_edge;
+
 		rynx::vec3f m_drag_action_mouse_origin;
 		rynx::vec3f m_drag_action_object_origin;
 		bool m_drag_action_active = false;
@@ -352,10 +445,17 @@ class editor_rules : public rynx::application::logic::iruleset {
 
 	rynx::key::logical key_createPolygon;
 	rynx::key::logical key_createBox;
+	rynx::key::logical key_saveLevel;
 
 	rynx::key::logical key_selection_tool;
 	rynx::key::logical key_polygon_tool;
 
+	game::frame_input::edge_id edge_createPolygon;
+	game::frame_input::edge_id edge_createBox;
+	game::frame_input::edge_id edge_saveLevel;
+	game::frame_input::edge_id edge_selection_tool;
+	game::frame_input::edge_id edge_polygon_tool;
+
 	rynx::collision_detection::category_id m_static_collisions;
 	rynx::collision_detection::category_id m_dynamic_collisions;
 
@@ -366,6 +466,7 @@ class editor_rules : public rynx::application::logic::iruleset {
 	
 	ieditor_tool* m_active_tool;
 	rynx::reflection::reflections& m_reflections;
+	std::string m_level_path;
 
 public:
 	editor_rules(
@@ -378,11 +479,13 @@ public:
 		rynx::collision_detection::category_id dynamic_collisions,
 		rynx::collision_detection::category_id static_collisions,
 		rynx::binary_config::id game_state,
-		rynx::binary_config::id editor_state)
+		rynx::binary_config::id editor_state,
+		std::string level_path)
 	: m_editor_menu(editor_menu)
 	, m_selection_tool(ctx)
 	, m_polygon_tool(ctx, &m_selection_tool)
 	, m_reflections(reflections)
+	, m_level_path(std::move(level_path))
 	{
 		// create editor menus
 		{
@@ -488,10 +591,18 @@ public:
 
 		key_createPolygon = gameInput.generateAndBindGameKey({ 'P' }, "Create polygon");
 		key_createBox = gameInput.generateAndBindGameKey({ 'O' }, "Create box");
+		key_saveLevel = gameInput.generateAndBindGameKey({ 'K' }, "Save level");
 		
 		key_selection_tool = gameInput.generateAndBindGameKey('_', "selection tool");
 		key_polygon_tool = gameInput.generateAndBindGameKey('.', "polygon tool");
 
+		auto& edges = ctx.get_resource<game::frame_input>();
+		edge_createPolygon = edges.track(key_createPolygon);
+		edge_createBox = edges.track(key_createBox);
+		edge_saveLevel = edges.track(key_saveLevel);
+		edge_selection_tool = edges.track(key_selection_tool);
+		edge_polygon_tool = edges.track(key_polygon_tool);
+
 		m_editor_state = editor_state;
 		m_game_state = game_state;
 		m_static_collisions = static_collisions;
@@ -509,15 +620,22 @@ private:
 		
 		m_active_tool->update(context);
 
+		// saving reads the whole ecs, so it is done here instead of making the editor tick an exclusive task.
+		if (context.get_resource<game::frame_input>().clicked(edge_saveLevel)) {
+			bool saved = game::save_level(m_level_path, context.get_resource<rynx::ecs>(), m_static_collisions);
+			std::cerr << (saved ? "level saved to: " : "failed to save level: ") << m_level_path << std::endl;
+		}
+
 		context.add_task("editor tick", [this, dt](
-			rynx::ecs& game_ecs,
+			const game::ecs_commands& commands,
 			rynx::mapped_input& gameInput,
+			const game::frame_input& edges,
 			rynx::camera& gameCamera)
 			{
-				if (gameInput.isKeyClicked(key_selection_tool)) {
+				if (edges.clicked(edge_selection_tool)) {
 					switch_to_tool(m_selection_tool);
 				}
-				if (gameInput.isKeyClicked(key_polygon_tool)) {
+				if (edges.clicked(edge_polygon_tool)) {
 					switch_to_tool(m_polygon_tool);
 				}
 
@@ -527,32 +645,16 @@ private:
 
 				if (mouse_z_plane.second) {
 					
-					if (gameInput.isKeyClicked(key_createPolygon)) {
-						auto p = rynx::Shape::makeTriangle(50.0f);
-						game_ecs.create(
-							rynx::components::position(mouse_z_plane.first, 0.0f),
-							rynx::components::collisions{ m_static_collisions.value },
-							rynx::components::boundary(p, mouse_z_plane.first, 0.0f),
-							rynx::components::radius(p.radius()),
-							rynx::components::color({ 0.2f, 1.0f, 0.3f, 1.0f }),
-							rynx::components::physical_body().mass(std::numeric_limits<float>::max()).friction(1.0f).elasticity(0.0f).moment_of_inertia(std::numeric_limits<float>::max()),
-							rynx::components::ignore_gravity(),
-							rynx::components::dampening{ 0.50f, 1.0f }
-						);
+					auto create = [&commands](auto&& components) {
+						std::apply([&commands](auto&&... c) { commands.create(std::move(c)...); }, std::move(components));
+					};
+
+					if (edges.clicked(edge_createPolygon)) {
+						create(game::static_polygon(rynx::Shape::makeTriangle(50.0f), mouse_z_plane.first, m_static_collisions));
 					}
 
-					if (gameInput.isKeyClicked(key_createBox)) {
-						auto p = rynx::Shape::makeBox(20.0f);
-						game_ecs.create(
-							rynx::components::position(mouse_z_plane.first, 0.0f),
-							rynx::components::motion{},
-							rynx::components::collisions{ m_dynamic_collisions.value },
-							rynx::components::boundary(p, mouse_z_plane.first, 0.0f),
-							rynx::components::radius(p.radius()),
-							rynx::components::color({ 0.2f, 1.0f, 0.3f, 1.0f }),
-							rynx::components::physical_body().mass(550.0f).friction(1.0f).elasticity(0.0f).moment_of_inertia(p, 2.0f),
-							rynx::matrix4{}
-						);
+					if (edges.clicked(edge_createBox)) {
+						create(game::dynamic_box(rynx::Shape::makeBox(20.0f), mouse_z_plane.first, m_dynamic_collisions));
 					}
 				}
 			});
@@ -576,12 +678,16 @@ class debug_input : public rynx::application::logic::iruleset {
 	rynx::key::logical key_toggleEditorState;
 	rynx::key::logical key_toggleFrustumCullState;
 
+	game::frame_input::edge_id edge_toggleGameState;
+	game::frame_input::edge_id edge_toggleEditorState;
+	game::frame_input::edge_id edge_toggleFrustumCullState;
+
 	rynx::binary_config::id m_editor_state;
 	rynx::binary_config::id m_game_state;
 	rynx::binary_config::id m_frustum_cull_state;
 
 public:
-	debug_input(rynx::mapped_input& gameInput, rynx::binary_config::id editor_state, rynx::binary_config::id game_state, rynx::binary_config::id frustum_cull_update_state) {
+	debug_input(rynx::mapped_input& gameInput, game::frame_input& edges, rynx::binary_config::id editor_state, rynx::binary_config::id game_state, rynx::binary_config::id frustum_cull_update_state) {
 		zoomOut = gameInput.generateAndBindGameKey('1', "zoom out");
 		zoomIn = gameInput.generateAndBindGameKey('2', "zoom in");
 
@@ -595,6 +701,10 @@ public:
 		key_toggleEditorState = gameInput.generateAndBindGameKey('2', "stateEditor");
 		key_toggleFrustumCullState = gameInput.generateAndBindGameKey('3', "stateFrustum");
 
+		edge_toggleGameState = edges.track(key_toggleGameState);
+		edge_toggleEditorState = edges.track(key_toggleEditorState);
+		edge_toggleFrustumCullState = edges.track(key_toggleFrustumCullState);
+
 		yawCounterClockWise = gameInput.generateAndBindGameKey('Q', "yawCCW");
 		yawClockWise = gameInput.generateAndBindGameKey('E', "yawCW");
 
@@ -607,36 +717,38 @@ private:
 	virtual void onFrameProcess(rynx::scheduler::context& context, float dt) override {
 		context.add_task("debug camera updates", [this, dt](
 			rynx::mapped_input& gameInput,
+			const game::frame_input& edges,
+			const game::camera_requests& camera_moves,
 			rynx::camera& gameCamera)
 		{
 			{
 				if (gameInput.isKeyDown(camera_orientation_key)) {
-					auto mouseDelta = gameInput.mouseDelta();
+					auto mouseDelta = edges.mouse_delta();
 					if (gameInput.isKeyDown(yawCounterClockWise))
 						mouseDelta.z = +dt * 10;
 					if (gameInput.isKeyDown(yawClockWise))
 						mouseDelta.z = -dt * 10;
 
-					gameCamera.rotate(mouseDelta);
+					camera_moves.rotate(mouseDelta);
 				}
 
 				const float camera_translate_multiplier = 200.4f * dt;
 				const float camera_zoom_multiplier = (1.0f - dt * 3.0f);
 				
-				if (gameInput.isKeyReleased(key_toggleEditorState)) {
+				if (edges.released(edge_toggleEditorState)) {
 					m_editor_state.toggle();
 				}
-				if (gameInput.isKeyReleased(key_toggleGameState)) {
+				if (edges.released(edge_toggleGameState)) {
 					m_game_state.toggle();
 				}
-				if (gameInput.isKeyReleased(key_toggleFrustumCullState)) {
+				if (edges.released(edge_toggleFrustumCullState)) {
 					m_frustum_cull_state.toggle();
 				}
 
-				if (gameInput.isKeyDown(cameraUp)) { gameCamera.translate(gameCamera.local_forward() * camera_translate_multiplier); }
-				if (gameInput.isKeyDown(cameraDown)) { gameCamera.translate(-gameCamera.local_forward() * camera_translate_multiplier); }
-				if (gameInput.isKeyDown(cameraLeft)) { gameCamera.translate(gameCamera.local_left() * camera_translate_multiplier); }
-				if (gameInput.isKeyDown(cameraRight)) { gameCamera.translate(-gameCamera.local_left() * camera_translate_multiplier); }
+				if (gameInput.isKeyDown(cameraUp)) { camera_moves.translate(gameCamera.local_forward() * camera_translate_multiplier); }
+				if (gameInput.isKeyDown(cameraDown)) { camera_moves.translate(-gameCamera.local_forward() * camera_translate_multiplier); }
+				if (gameInput.isKeyDown(cameraLeft)) { camera_moves.translate(gameCamera.local_left() * camera_translate_multiplier); }
+				if (gameInput.isKeyDown(cameraRight)) { camera_moves.translate(-gameCamera.local_left() * camera_translate_multiplier); }
 				// if (gameInput.isKeyDown(zoomOut)) { cameraPosition *= vec3<float>(1, 1.0f, 1.0f * camera_zoom_multiplier); }
 				// if (gameInput.isKeyDown(zoomIn)) { cameraPosition *= vec3<float>(1, 1.0f, 1.0f / camera_zoom_multiplier); }
 			}
@@ -644,32 +756,6 @@ private:
 	}
 };
 
-class game_collisions {
-public:
-	game_collisions(rynx::collision_detection& collisionDetection) {
-		collisionCategoryDynamic = collisionDetection.add_category();
-		collisionCategoryStatic = collisionDetection.add_category();
-		collisionCategoryProjectiles = collisionDetection.add_category();
-
-		{
-			collisionDetection.enable_collisions_between(collisionCategoryDynamic, collisionCategoryDynamic); // enable dynamic <-> dynamic collisions
-			collisionDetection.enable_collisions_between(collisionCategoryDynamic, collisionCategoryStatic.ignore_collisions()); // enable dynamic <-> static collisions
-
-			collisionDetection.enable_collisions_between(collisionCategoryProjectiles, collisionCategoryStatic.ignore_collisions()); // projectile <-> static
-			collisionDetection.enable_collisions_between(collisionCategoryProjectiles, collisionCategoryDynamic); // projectile <-> dynamic
-		}
-	}
-
-	rynx::collision_detection::category_id category_dynamic() const { return collisionCategoryDynamic; }
-	rynx::collision_detection::category_id category_static() const { return collisionCategoryStatic; }
-	rynx::collision_detection::category_id category_projectiles() const { return collisionCategoryProjectiles; }
-
-private:
-	rynx::collision_detection::category_id collisionCategoryDynamic;
-	rynx::collision_detection::category_id collisionCategoryStatic;
-	rynx::collision_detection::category_id collisionCategoryProjectiles;
-};
-
 class GameMenu {
 
 	rynx::menu::System system;
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <rynx/scheduler/task.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace game {
+	// reduces [0, count) in chunks of chunk_size on the scheduler workers. map(begin, end) reduces one chunk,
+	// and the partial results are combined in chunk order on the calling thread. the result does not depend on
+	// which worker ran which chunk, so floating point sums and tie breaks match between runs.
+	// items are only indices. reducing over a list of entity ids costs an entity lookup per item, so chunk_size
+	// is a work size for the scheduler, and this only pays off when the per item work outweighs the lookup.
+	template<typename T, typename Map, typename Combine>
+	T parallel_reduce(rynx::scheduler::task& task_context, size_t count, size_t chunk_size, T identity, Map&& map, Combine&& combine) {
+		chunk_size = std::max<size_t>(1, chunk_size);
+		if (count <= chunk_size) {
+			return combine(std::move(identity), map(size_t(0), count));
+		}
+
+		const size_t num_chunks = (count + chunk_size - 1) / chunk_size;
+		std::vector<T> partials(num_chunks, identity);
+		task_context.parallel().for_each(0, static_cast<int64_t>(num_chunks), [&](int64_t chunk) {
+			const size_t begin = static_cast<size_t>(chunk) * chunk_size;
+			partials[chunk] = map(begin, std::min(count, begin + chunk_size));
+		}, 1);
+
+		T result = std::move(identity);
+		for (auto& partial : partials) {
+			result = combine(std::move(result), std::move(partial));
+		}
+		return result;
+	}
+}
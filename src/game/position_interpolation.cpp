@@ -0,0 +1,41 @@
+#include <game/position_interpolation.hpp>
+
+#include <rynx/tech/components.hpp>
+#include <rynx/tech/profiling.hpp>
+
+#include <cmath>
+
+namespace {
+	float lerp_angle(float a, float b, float t) {
+		constexpr float two_pi = 6.28318530718f;
+		return a + std::remainder(b - a, two_pi) * t;
+	}
+}
+
+void game::position_interpolation::apply(rynx::ecs& ecs, const game::transform_changes& changes, float alpha) {
+	rynx_profile("Game", "interpolate positions");
+	m_simulated.clear();
+	for (const auto& change : changes.last_tick()) {
+		if (!ecs.exists(change.id)) {
+			continue;
+		}
+
+		auto& pos = ecs[change.id].get<rynx::components::position>();
+		const game::pose2d simulated_pose = game::pose2d::from(pos);
+		const game::vec2 position = change.before.position + (simulated_pose.position - change.before.position) * alpha;
+		m_simulated.emplace_back(simulated{ change.id, simulated_pose });
+		pos.value.x = position.x;
+		pos.value.y = position.y;
+		pos.angle = lerp_angle(change.before.angle, simulated_pose.angle, alpha);
+	}
+}
+
+void game::position_interpolation::restore(rynx::ecs& ecs) {
+	for (const auto& entry : m_simulated) {
+		auto& pos = ecs[entry.id].get<rynx::components::position>();
+		pos.value.x = entry.pose.position.x;
+		pos.value.y = entry.pose.position.y;
+		pos.angle = entry.pose.angle;
+	}
+	m_simulated.clear();
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <game/transform_changes.hpp>
+#include <rynx/tech/ecs.hpp>
+
+#include <vector>
+
+namespace game {
+	// renders moving entities between their last two logic states.
+	// apply() overwrites the positions of the entities that moved in the last logic tick with interpolated ones,
+	// just before render preparation reads them, and restore() puts the simulated positions back before the next
+	// logic tick runs. the poses before the tick come from game::transform_changes, so entities that did not move
+	// are never visited, and a body knocked out of rest during the tick is interpolated like any other.
+	class position_interpolation {
+	public:
+		void apply(rynx::ecs& ecs, const game::transform_changes& changes, float alpha);
+		void restore(rynx::ecs& ecs);
+
+	private:
+		struct simulated {
+			rynx::ecs::id id;
+			game::pose2d pose;
+		};
+
+		std::vector<simulated> m_simulated;
+	};
+}
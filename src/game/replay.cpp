@@ -0,0 +1,379 @@
+
+#include <game/replay.hpp>
+#include <game/mapped_file.hpp>
+#include <game/transform_changes.hpp>
+
+#include <rynx/scheduler/context.hpp>
+#include <rynx/tech/components.hpp>
+#include <rynx/application/components.hpp>
+#include <rynx/tech/profiling.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace {
+	constexpr uint32_t replay_magic = 0x4c505252; // "RRPL"
+	constexpr uint32_t replay_version = 1;
+
+	constexpr float two_pi = 6.28318530718f;
+	constexpr float position_scale = 16.0f; // 1/16 world units.
+	constexpr float angle_scale = 65536.0f / two_pi; // full turn wraps at 16 bits.
+	constexpr uint32_t angle_mask = 0xffff;
+
+	struct file_header {
+		uint32_t magic;
+		uint32_t version;
+		float sample_rate;
+		int32_t sample_count;
+		uint64_t bit_count;
+		float radius[game::replay_track::part_count];
+	};
+
+	bool is_angle_channel(int32_t channel) {
+		return (channel % game::replay_track::channels_per_part) == 2;
+	}
+
+	int64_t predict(int32_t samples, int32_t prev, int32_t prev2) {
+		if (samples == 0) {
+			return 0;
+		}
+		if (samples == 1) {
+			return prev;
+		}
+		return 2 * int64_t(prev) - prev2;
+	}
+
+	uint64_t zigzag(int64_t value) {
+		return (uint64_t(value) << 1) ^ uint64_t(value >> 63);
+	}
+
+	int64_t unzigzag(uint64_t value) {
+		return int64_t(value >> 1) ^ -int64_t(value & 1);
+	}
+
+	uint64_t low_bits(int32_t count) {
+		return (count >= 64) ? ~uint64_t(0) : ((uint64_t(1) << count) - 1);
+	}
+
+	// shortest way around from a to b.
+	float lerp_angle(float a, float b, float t) {
+		float delta = std::remainder(b - a, two_pi);
+		return a + delta * t;
+	}
+}
+
+void game::replay_track::clear() {
+	sample_count = 0;
+	bit_count = 0;
+	bits.clear();
+}
+
+bool game::replay_track::save(const std::string& path) const {
+	file_header header{};
+	header.magic = replay_magic;
+	header.version = replay_version;
+	header.sample_rate = sample_rate;
+	header.sample_count = sample_count;
+	header.bit_count = bit_count;
+	std::copy(radius.begin(), radius.end(), header.radius);
+
+	std::error_code error;
+	std::filesystem::path file_path(path);
+	if (file_path.has_parent_path()) {
+		std::filesystem::create_directories(file_path.parent_path(), error);
+	}
+
+	std::ofstream out(path, std::ios::binary | std::ios::trunc);
+	if (!out) {
+		return false;
+	}
+
+	out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	out.write(reinterpret_cast<const char*>(bits.data()), static_cast<std::streamsize>(bits.size() * sizeof(uint64_t)));
+	return static_cast<bool>(out);
+}
+
+bool game::replay_track::load(const std::string& path) {
+	game::mapped_file file(path);
+	if (!file.is_open() || file.size() < sizeof(file_header)) {
+		return false;
+	}
+
+	file_header header;
+	std::memcpy(&header, file.data(), sizeof(header));
+
+	// every channel of every sample takes at least one bit, and all bits have to be in the file.
+	const uint64_t payload_words = (file.size() - sizeof(file_header)) / sizeof(uint64_t);
+	if (header.magic != replay_magic ||
+		header.version != replay_version ||
+		header.sample_rate <= 0.0f ||
+		header.sample_count < 0 ||
+		header.bit_count > payload_words * 64 ||
+		uint64_t(header.sample_count) * channel_count > header.bit_count)
+	{
+		return false;
+	}
+
+	const uint64_t num_words = (header.bit_count + 63) / 64;
+
+	sample_rate = header.sample_rate;
+	sample_count = header.sample_count;
+	bit_count = header.bit_count;
+	std::copy(header.radius, header.radius + part_count, radius.begin());
+	bits.resize(num_words);
+	std::memcpy(bits.data(), file.data() + sizeof(file_header), num_words * sizeof(uint64_t));
+	return true;
+}
+
+void game::replay_encoder::begin(replay_track& track) {
+	track.clear();
+
+	// roughly ten minutes at the default rate, so recording does not reallocate during a normal run.
+	track.bits.reserve(48 * 1024);
+	m_prev.fill(0);
+	m_prev2.fill(0);
+}
+
+void game::replay_encoder::write_bits(replay_track& track, uint64_t value, int32_t count) {
+	while (count > 0) {
+		const uint64_t word = track.bit_count / 64;
+		const int32_t offset = static_cast<int32_t>(track.bit_count % 64);
+		if (word == track.bits.size()) {
+			track.bits.emplace_back(0);
+		}
+
+		const int32_t take = std::min(count, 64 - offset);
+		track.bits[word] |= (value & low_bits(take)) << offset;
+		value = (take >= 64) ? 0 : (value >> take);
+		count -= take;
+		track.bit_count += take;
+	}
+}
+
+// exp-golomb: n zero bits, a one bit and the n low bits of value + 1. zero costs a single bit.
+void game::replay_encoder::write_code(replay_track& track, uint64_t value) {
+	const uint64_t v = value + 1;
+	const int32_t n = static_cast<int32_t>(std::bit_width(v)) - 1;
+	write_bits(track, 0, n);
+	write_bits(track, 1, 1);
+	write_bits(track, v, n);
+}
+
+void game::replay_encoder::write(replay_track& track, const replay_sample& sample) {
+	for (int32_t part = 0; part < replay_track::part_count; ++part) {
+		const int32_t quantized[replay_track::channels_per_part] = {
+			static_cast<int32_t>(std::lround(sample.position[part].x * position_scale)),
+			static_cast<int32_t>(std::lround(sample.position[part].y * position_scale)),
+			static_cast<int32_t>(static_cast<uint32_t>(std::lround(sample.angle[part] * angle_scale)) & angle_mask)
+		};
+
+		for (int32_t k = 0; k < replay_track::channels_per_part; ++k) {
+			const int32_t channel = part * replay_track::channels_per_part + k;
+			const int64_t predicted = predict(track.sample_count, m_prev[channel], m_prev2[channel]);
+
+			int64_t residual = quantized[k] - predicted;
+			if (is_angle_channel(channel)) {
+				residual = static_cast<int16_t>(static_cast<uint16_t>(residual));
+			}
+			write_code(track, zigzag(residual));
+
+			m_prev2[channel] = m_prev[channel];
+			m_prev[channel] = quantized[k];
+		}
+	}
+
+	++track.sample_count;
+}
+
+void game::replay_decoder::begin(const replay_track& track) {
+	m_track = &track;
+	m_cursor = 0;
+	m_samples_read = 0;
+	m_failed = false;
+	m_prev.fill(0);
+	m_prev2.fill(0);
+}
+
+// reading past the end of the track reads nothing and marks the decoder failed.
+uint64_t game::replay_decoder::read_bits(int32_t count) {
+	if (count > 0 && (m_cursor >= m_track->bit_count || uint64_t(count) > m_track->bit_count - m_cursor)) {
+		m_failed = true;
+		return 0;
+	}
+
+	uint64_t value = 0;
+	int32_t written = 0;
+	while (written < count) {
+		const uint64_t word = m_cursor / 64;
+		const int32_t offset = static_cast<int32_t>(m_cursor % 64);
+		const int32_t take = std::min(count - written, 64 - offset);
+
+		value |= ((m_track->bits[word] >> offset) & low_bits(take)) << written;
+		written += take;
+		m_cursor += take;
+	}
+	return value;
+}
+
+uint64_t game::replay_decoder::read_code() {
+	int32_t n = 0;
+	while (n < 63 && read_bits(1) == 0 && !m_failed) {
+		++n;
+	}
+	return ((uint64_t(1) << n) | read_bits(n)) - 1;
+}
+
+bool game::replay_decoder::read(replay_sample& sample) {
+	if (!m_track || m_failed || m_samples_read >= m_track->sample_count) {
+		return false;
+	}
+
+	// decoded aside, so that a failed read leaves the caller's sample as it was.
+	replay_sample decoded;
+	for (int32_t part = 0; part < replay_track::part_count; ++part) {
+		int32_t quantized[replay_track::channels_per_part];
+		for (int32_t k = 0; k < replay_track::channels_per_part; ++k) {
+			const int32_t channel = part * replay_track::channels_per_part + k;
+			const int64_t predicted = predict(m_samples_read, m_prev[channel], m_prev2[channel]);
+
+			int64_t value = predicted + unzigzag(read_code());
+			if (is_angle_channel(channel)) {
+				value &= angle_mask;
+			}
+			quantized[k] = static_cast<int32_t>(value);
+
+			m_prev2[channel] = m_prev[channel];
+			m_prev[channel] = quantized[k];
+		}
+
+		decoded.position[part] = rynx::vec3f(quantized[0] / position_scale, quantized[1] / position_scale, 0.0f);
+		decoded.angle[part] = quantized[2] / angle_scale;
+	}
+
+	if (m_failed) {
+		return false;
+	}
+
+	sample = decoded;
+	++m_samples_read;
+	return true;
+}
+
+game::replay_recorder::replay_recorder(game::bike_instance bike, float sample_rate) : m_bike(bike) {
+	m_track.sample_rate = sample_rate;
+	m_encoder.begin(m_track);
+}
+
+void game::replay_recorder::restart() {
+	m_encoder.begin(m_track);
+	m_time_to_next_sample = 0.0f;
+}
+
+void game::replay_recorder::onFrameProcess(rynx::scheduler::context& context, float dt) {
+	context.add_task("replay recording", [this, dt](rynx::ecs::view<const rynx::components::position, const rynx::components::radius> ecs) {
+		rynx_profile("Game", "replay recording");
+
+		m_time_to_next_sample -= dt;
+		if (m_time_to_next_sample > 0.0f) {
+			return;
+		}
+
+		const rynx::ecs::id parts[replay_track::part_count] = { m_bike.bike_body, m_bike.back_wheel, m_bike.front_wheel, m_bike.head };
+		replay_sample sample;
+		for (int32_t part = 0; part < replay_track::part_count; ++part) {
+			if (!ecs.exists(parts[part])) {
+				return;
+			}
+
+			auto entity = ecs[parts[part]];
+			const auto& pos = entity.get<const rynx::components::position>();
+			sample.position[part] = pos.value;
+			sample.angle[part] = pos.angle;
+
+			if (m_track.sample_count == 0) {
+				m_track.radius[part] = entity.get<const rynx::components::radius>().r;
+			}
+		}
+
+		// a long frame records the current state for each sample it covers, so that track time stays in sync.
+		while (m_time_to_next_sample <= 0.0f) {
+			m_encoder.write(m_track, sample);
+			m_time_to_next_sample += 1.0f / m_track.sample_rate;
+		}
+	});
+}
+
+game::replay_player::replay_player(replay_track track, rynx::graphics::mesh_collection& meshes)
+	: m_track(std::move(track))
+	, m_meshes(meshes)
+{
+	restart();
+}
+
+void game::replay_player::restart() {
+	m_decoder.begin(m_track);
+	m_time = 0.0f;
+	m_finished = !m_decoder.read(m_from);
+	m_to = m_from;
+	m_decoder.read(m_to);
+
+	if (m_decoder.failed()) {
+		std::cerr << "replay track ends before its last sample, playback stops at sample " << m_decoder.samples_read() << std::endl;
+	}
+}
+
+void game::replay_player::spawn_ghost(rynx::ecs& ecs) {
+	const char* mesh_names[replay_track::part_count] = { "bike_body", "wheel", "wheel", "head" };
+	for (int32_t part = 0; part < replay_track::part_count; ++part) {
+		m_ghost[part] = ecs.create(
+			rynx::components::position(m_from.position[part], m_from.angle[part]),
+			rynx::components::mesh(m_meshes.get(mesh_names[part])),
+			rynx::matrix4(),
+			rynx::components::radius(m_track.radius[part]),
+			rynx::components::color({ 0.6f, 0.8f, 1.0f, 0.4f })
+		);
+	}
+	m_spawned = true;
+}
+
+// note: ghost entities are created here instead of in a task, same as terrain chunks.
+void game::replay_player::onFrameProcess(rynx::scheduler::context& context, float dt) {
+	// a track without a single readable sample has nothing to show.
+	if (!m_spawned && !(m_finished && m_decoder.samples_read() == 0)) {
+		spawn_ghost(context.get_resource<rynx::ecs>());
+	}
+
+	context.add_task("replay playback", [this, dt](rynx::ecs::view<rynx::components::position> ecs, const game::transform_changes& changes) {
+		rynx_profile("Game", "replay playback");
+
+		if (!m_finished) {
+			m_time += dt;
+
+			// m_to is the sample at index samples_read - 1.
+			while (m_time * m_track.sample_rate > float(m_decoder.samples_read() - 1)) {
+				m_from = m_to;
+				if (!m_decoder.read(m_to)) {
+					m_finished = true;
+					break;
+				}
+			}
+		}
+
+		const float t = m_finished ? 1.0f : std::clamp(m_time * m_track.sample_rate - float(m_decoder.samples_read() - 2), 0.0f, 1.0f);
+		for (int32_t part = 0; part < replay_track::part_count; ++part) {
+			if (!ecs.exists(m_ghost[part])) {
+				continue;
+			}
+
+			auto& pos = ecs[m_ghost[part]].get<rynx::components::position>();
+			pos.value = m_from.position[part] + (m_to.position[part] - m_from.position[part]) * t;
+			pos.angle = lerp_angle(m_from.angle[part], m_to.angle[part], t);
+			changes.mark(m_ghost[part]);
+		}
+	});
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <game/bike_creation.hpp>
+
+#include <rynx/application/logic.hpp>
+#include <rynx/tech/ecs.hpp>
+#include <rynx/graphics/renderer/meshrenderer.hpp>
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace game {
+	// recorded run of one bike. positions and angles of each body part are sampled at a fixed rate,
+	// quantized, predicted from the two previous samples and the residuals are stored as exp-golomb codes.
+	// motion is not stored, it follows from consecutive positions.
+	struct replay_track {
+		enum part : int32_t {
+			part_bike_body,
+			part_back_wheel,
+			part_front_wheel,
+			part_head,
+			part_count
+		};
+
+		static constexpr int32_t channels_per_part = 3; // x, y, angle
+		static constexpr int32_t channel_count = part_count * channels_per_part;
+
+		float sample_rate = 60.0f;
+		int32_t sample_count = 0;
+		uint64_t bit_count = 0;
+		std::array<float, part_count> radius{};
+		std::vector<uint64_t> bits;
+
+		float duration() const { return sample_count / sample_rate; }
+		size_t size_in_bytes() const { return (bit_count + 7) / 8; }
+
+		void clear();
+		bool save(const std::string& path) const;
+		bool load(const std::string& path);
+	};
+
+	// one decoded sample, in world units.
+	struct replay_sample {
+		std::array<rynx::vec3f, replay_track::part_count> position;
+		std::array<float, replay_track::part_count> angle;
+	};
+
+	// appends samples to a track.
+	class replay_encoder {
+	public:
+		void begin(replay_track& track);
+		void write(replay_track& track, const replay_sample& sample);
+
+	private:
+		void write_bits(replay_track& track, uint64_t value, int32_t count);
+		void write_code(replay_track& track, uint64_t value);
+
+		std::array<int32_t, replay_track::channel_count> m_prev{};
+		std::array<int32_t, replay_track::channel_count> m_prev2{};
+	};
+
+	// reads samples back from a track in order. never allocates.
+	// read fails once the track runs out of bits, which only happens with a damaged track.
+	class replay_decoder {
+	public:
+		void begin(const replay_track& track);
+		bool read(replay_sample& sample);
+		int32_t samples_read() const { return m_samples_read; }
+		bool failed() const { return m_failed; }
+
+	private:
+		uint64_t read_bits(int32_t count);
+		uint64_t read_code();
+
+		const replay_track* m_track = nullptr;
+		uint64_t m_cursor = 0;
+		int32_t m_samples_read = 0;
+		bool m_failed = false;
+		std::array<int32_t, replay_track::channel_count> m_prev{};
+		std::array<int32_t, replay_track::channel_count> m_prev2{};
+	};
+
+	// samples a bike at a fixed rate regardless of frame time.
+	class replay_recorder : public rynx::application::logic::iruleset {
+	public:
+		replay_recorder(game::bike_instance bike, float sample_rate = 60.0f);
+		virtual ~replay_recorder() = default;
+		virtual void onFrameProcess(rynx::scheduler::context& context, float dt) override;
+
+		const replay_track& track() const { return m_track; }
+		void restart();
+
+	private:
+		game::bike_instance m_bike;
+		replay_track m_track;
+		replay_encoder m_encoder;
+		float m_time_to_next_sample = 0.0f;
+	};
+
+	// drives kinematic ghost entities from a recorded track. ghosts have no motion, collisions or
+	// physical body, so physics never sees them. samples are interpolated to the current frame time.
+	class replay_player : public rynx::application::logic::iruleset {
+	public:
+		replay_player(replay_track track, rynx::graphics::mesh_collection& meshes);
+		virtual ~replay_player() = default;
+		virtual void onFrameProcess(rynx::scheduler::context& context, float dt) override;
+
+		void restart();
+		bool finished() const { return m_finished; }
+
+	private:
+		void spawn_ghost(rynx::ecs& ecs);
+
+		replay_track m_track;
+		replay_decoder m_decoder;
+		replay_sample m_from;
+		replay_sample m_to;
+		float m_time = 0.0f;
+		bool m_finished = false;
+
+		rynx::graphics::mesh_collection& m_meshes;
+		std::array<rynx::ecs::id, replay_track::part_count> m_ghost;
+		bool m_spawned = false;
+	};
+}
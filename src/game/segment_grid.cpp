@@ -0,0 +1,63 @@
+
+#include <game/segment_grid.hpp>
+
+void game::segment_grid::build(const rynx::polygon& shape) {
+	m_cell_begin.clear();
+	m_cell_segments.clear();
+
+	const int32_t count = shape.size();
+	if (count == 0) {
+		m_columns = 0;
+		m_rows = 0;
+		return;
+	}
+
+	float min_x = 1e30f, min_y = 1e30f, max_x = -1e30f, max_y = -1e30f;
+	float total_length = 0.0f;
+	for (int32_t i = 0; i < count; ++i) {
+		const auto s = shape.segment(i);
+		min_x = std::min({ min_x, s.p1.x, s.p2.x });
+		min_y = std::min({ min_y, s.p1.y, s.p2.y });
+		max_x = std::max({ max_x, s.p1.x, s.p2.x });
+		max_y = std::max({ max_y, s.p1.y, s.p2.y });
+		total_length += (s.p2 - s.p1).length();
+	}
+
+	const float width = std::max(max_x - min_x, 1e-3f);
+	const float height = std::max(max_y - min_y, 1e-3f);
+	const float area_cell = std::sqrt(width * height / count);
+	m_cell_size = std::max({ total_length / count, area_cell, 1e-3f });
+	m_min_x = min_x;
+	m_min_y = min_y;
+	m_columns = std::max(1, static_cast<int32_t>(std::ceil(width / m_cell_size)));
+	m_rows = std::max(1, static_cast<int32_t>(std::ceil(height / m_cell_size)));
+
+	// counting pass, then fill. cells store segments in index order.
+	auto for_each_cell = [&](int32_t i, auto&& op) {
+		const auto s = shape.segment(i);
+		const int32_t x0 = cell_x(std::min(s.p1.x, s.p2.x));
+		const int32_t x1 = cell_x(std::max(s.p1.x, s.p2.x));
+		const int32_t y0 = cell_y(std::min(s.p1.y, s.p2.y));
+		const int32_t y1 = cell_y(std::max(s.p1.y, s.p2.y));
+		for (int32_t y = y0; y <= y1; ++y) {
+			for (int32_t x = x0; x <= x1; ++x) {
+				op(y * m_columns + x);
+			}
+		}
+	};
+
+	m_cell_begin.assign(size_t(m_columns) * m_rows + 1, 0);
+	for (int32_t i = 0; i < count; ++i) {
+		for_each_cell(i, [this](int32_t cell) { ++m_cell_begin[cell + 1]; });
+	}
+
+	for (size_t cell = 1; cell < m_cell_begin.size(); ++cell) {
+		m_cell_begin[cell] += m_cell_begin[cell - 1];
+	}
+
+	std::vector<int32_t> cursor(m_cell_begin.begin(), m_cell_begin.end() - 1);
+	m_cell_segments.resize(m_cell_begin.back());
+	for (int32_t i = 0; i < count; ++i) {
+		for_each_cell(i, [&](int32_t cell) { m_cell_segments[cursor[cell]++] = i; });
+	}
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <rynx/math/geometry/polygon.hpp>
+#include <rynx/math/vector.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace game {
+	// uniform grid over the segments of one polygon, so that point queries against large boundaries
+	// only look at segments near the point instead of scanning all of them.
+	// every segment is listed in each cell its bounding box touches.
+	class segment_grid {
+	public:
+		// cell size follows the average segment length, capped so that the grid stays around segment count cells.
+		void build(const rynx::polygon& shape);
+
+		bool empty() const { return m_cell_segments.empty(); }
+
+		// visits cells outwards from point and returns { segment index, distance squared } of the smallest
+		// distance_sqr(segment index) below max_distance_sqr, or { -1, max_distance_sqr } if none is closer.
+		// distance_sqr may measure to any point within the segment's bounding box, like either end point or the middle.
+		template<typename DistanceSqr>
+		std::pair<int32_t, float> closest(rynx::vec3f point, float max_distance_sqr, DistanceSqr&& distance_sqr) const {
+			std::pair<int32_t, float> best(-1, max_distance_sqr);
+			if (empty()) {
+				return best;
+			}
+
+			// a point outside the grid is searched from the nearest cell, and is at least its distance to the grid further from everything.
+			const float outside_x = std::max({ m_min_x - point.x, point.x - (m_min_x + m_columns * m_cell_size), 0.0f });
+			const float outside_y = std::max({ m_min_y - point.y, point.y - (m_min_y + m_rows * m_cell_size), 0.0f });
+			const float outside_sqr = outside_x * outside_x + outside_y * outside_y;
+
+			const int32_t cx = cell_x(point.x);
+			const int32_t cy = cell_y(point.y);
+			const int32_t max_ring = std::max(m_columns, m_rows);
+			for (int32_t ring = 0; ring <= max_ring; ++ring) {
+				// everything in this ring and beyond is at least this far away.
+				const float ring_distance = std::max(ring - 1, 0) * m_cell_size;
+				if (outside_sqr + ring_distance * ring_distance >= best.second) {
+					break;
+				}
+
+				for (int32_t y = cy - ring; y <= cy + ring; ++y) {
+					if (y < 0 || y >= m_rows) {
+						continue;
+					}
+
+					const bool edge_row = (y == cy - ring || y == cy + ring);
+					const int32_t step = edge_row ? 1 : 2 * ring;
+					for (int32_t x = cx - ring; x <= cx + ring; x += step) {
+						if (x < 0 || x >= m_columns) {
+							continue;
+						}
+
+						const int32_t cell = y * m_columns + x;
+						for (int32_t k = m_cell_begin[cell]; k < m_cell_begin[cell + 1]; ++k) {
+							const int32_t segment = m_cell_segments[k];
+							const float d = distance_sqr(segment);
+							if (d < best.second || (d == best.second && best.first != -1 && segment < best.first)) {
+								best = { segment, d };
+							}
+						}
+					}
+				}
+			}
+
+			return best;
+		}
+
+	private:
+		int32_t cell_x(float x) const { return std::clamp(static_cast<int32_t>(std::floor((x - m_min_x) / m_cell_size)), 0, m_columns - 1); }
+		int32_t cell_y(float y) const { return std::clamp(static_cast<int32_t>(std::floor((y - m_min_y) / m_cell_size)), 0, m_rows - 1); }
+
+		float m_min_x = 0.0f;
+		float m_min_y = 0.0f;
+		float m_cell_size = 1.0f;
+		int32_t m_columns = 0;
+		int32_t m_rows = 0;
+		std::vector<int32_t> m_cell_begin; // m_columns * m_rows + 1 offsets into m_cell_segments.
+		std::vector<int32_t> m_cell_segments;
+	};
+}
@@ -0,0 +1,147 @@
+
+#include <game/segment_kernels.hpp>
+#include <game/simd_math.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+	constexpr float min_distance = 1e-4f; // below this the direction to the closest point is noise, the face normal is used.
+	constexpr float min_length_sqr = 1e-12f;
+
+	inline bool circle_vs_segment(float ax, float ay, float bx, float by, float cx, float cy, float radius, game::segment_contact& out) {
+		const float abx = bx - ax;
+		const float aby = by - ay;
+		const float length_sqr = std::max(abx * abx + aby * aby, min_length_sqr);
+		const float inv_length = 1.0f / std::sqrt(length_sqr);
+		const float nx = -aby * inv_length;
+		const float ny = abx * inv_length;
+
+		const float dx = cx - ax;
+		const float dy = cy - ay;
+		const float signed_distance = dx * nx + dy * ny;
+		const float t_raw = (dx * abx + dy * aby) / length_sqr;
+
+		if (signed_distance < 0.0f) {
+			if (t_raw < 0.0f || t_raw >= 1.0f) {
+				return false;
+			}
+			out.x = ax + abx * t_raw;
+			out.y = ay + aby * t_raw;
+			out.normal_x = nx;
+			out.normal_y = ny;
+			out.depth = radius - signed_distance;
+			return true;
+		}
+
+		const float t = std::clamp(t_raw, 0.0f, 1.0f);
+		const float qx = ax + abx * t;
+		const float qy = ay + aby * t;
+		const float ddx = cx - qx;
+		const float ddy = cy - qy;
+		const float distance_sqr = ddx * ddx + ddy * ddy;
+		if (distance_sqr >= radius * radius) {
+			return false;
+		}
+
+		const float distance = std::sqrt(distance_sqr);
+		const bool use_face = distance <= min_distance;
+		out.x = qx;
+		out.y = qy;
+		out.normal_x = use_face ? nx : ddx / distance;
+		out.normal_y = use_face ? ny : ddy / distance;
+		out.depth = radius - distance;
+		return true;
+	}
+}
+
+int32_t game::circle_vs_segments_scalar(
+	const float* ax, const float* ay, const float* bx, const float* by, int32_t count,
+	float cx, float cy, float radius, segment_contact* out)
+{
+	int32_t written = 0;
+	for (int32_t i = 0; i < count; ++i) {
+		if (circle_vs_segment(ax[i], ay[i], bx[i], by[i], cx, cy, radius, out[written])) {
+			out[written++].segment = i;
+		}
+	}
+	return written;
+}
+
+int32_t game::circle_vs_segments(
+	const float* ax, const float* ay, const float* bx, const float* by, int32_t count,
+	float cx, float cy, float radius, segment_contact* out)
+{
+	int32_t written = 0;
+	int32_t i = 0;
+
+#if GAME_SSE2
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 r = _mm_set1_ps(radius);
+	const __m128 r_sqr = _mm_set1_ps(radius * radius);
+	const __m128 center_x = _mm_set1_ps(cx);
+	const __m128 center_y = _mm_set1_ps(cy);
+	const __m128 epsilon = _mm_set1_ps(min_distance);
+	const __m128 tiny = _mm_set1_ps(min_length_sqr);
+
+	auto select = [](__m128 mask, __m128 a, __m128 b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); };
+
+	for (; i + 4 <= count; i += 4) {
+		const __m128 a_x = _mm_loadu_ps(ax + i);
+		const __m128 a_y = _mm_loadu_ps(ay + i);
+		const __m128 abx = _mm_sub_ps(_mm_loadu_ps(bx + i), a_x);
+		const __m128 aby = _mm_sub_ps(_mm_loadu_ps(by + i), a_y);
+		const __m128 length_sqr = _mm_max_ps(_mm_add_ps(_mm_mul_ps(abx, abx), _mm_mul_ps(aby, aby)), tiny);
+		const __m128 inv_length = _mm_div_ps(one, _mm_sqrt_ps(length_sqr));
+		const __m128 nx = _mm_mul_ps(_mm_sub_ps(zero, aby), inv_length);
+		const __m128 ny = _mm_mul_ps(abx, inv_length);
+
+		const __m128 dx = _mm_sub_ps(center_x, a_x);
+		const __m128 dy = _mm_sub_ps(center_y, a_y);
+		const __m128 signed_distance = _mm_add_ps(_mm_mul_ps(dx, nx), _mm_mul_ps(dy, ny));
+		const __m128 t_raw = _mm_div_ps(_mm_add_ps(_mm_mul_ps(dx, abx), _mm_mul_ps(dy, aby)), length_sqr);
+		const __m128 t = _mm_min_ps(_mm_max_ps(t_raw, zero), one);
+
+		const __m128 qx = _mm_add_ps(a_x, _mm_mul_ps(abx, t));
+		const __m128 qy = _mm_add_ps(a_y, _mm_mul_ps(aby, t));
+		const __m128 ddx = _mm_sub_ps(center_x, qx);
+		const __m128 ddy = _mm_sub_ps(center_y, qy);
+		const __m128 distance_sqr = _mm_add_ps(_mm_mul_ps(ddx, ddx), _mm_mul_ps(ddy, ddy));
+
+		const __m128 behind = _mm_cmplt_ps(signed_distance, zero);
+		const __m128 within = _mm_and_ps(_mm_cmpge_ps(t_raw, zero), _mm_cmplt_ps(t_raw, one));
+		const __m128 sunk = _mm_and_ps(behind, within);
+		const __m128 touching = _mm_andnot_ps(behind, _mm_cmplt_ps(distance_sqr, r_sqr));
+
+		int hits = _mm_movemask_ps(_mm_or_ps(sunk, touching));
+		if (hits == 0) {
+			continue;
+		}
+
+		const __m128 distance = _mm_sqrt_ps(distance_sqr);
+		const __m128 use_face = _mm_or_ps(sunk, _mm_cmple_ps(distance, epsilon));
+		const __m128 inv_distance = _mm_div_ps(one, _mm_max_ps(distance, epsilon));
+
+		alignas(16) float px[4], py[4], normal_x[4], normal_y[4], depth[4];
+		_mm_store_ps(px, select(sunk, _mm_add_ps(a_x, _mm_mul_ps(abx, t_raw)), qx));
+		_mm_store_ps(py, select(sunk, _mm_add_ps(a_y, _mm_mul_ps(aby, t_raw)), qy));
+		_mm_store_ps(normal_x, select(use_face, nx, _mm_mul_ps(ddx, inv_distance)));
+		_mm_store_ps(normal_y, select(use_face, ny, _mm_mul_ps(ddy, inv_distance)));
+		_mm_store_ps(depth, _mm_sub_ps(r, select(sunk, signed_distance, distance)));
+
+		for (int32_t lane = 0; lane < 4; ++lane) {
+			if (hits & (1 << lane)) {
+				out[written++] = segment_contact{ i + lane, px[lane], py[lane], normal_x[lane], normal_y[lane], depth[lane] };
+			}
+		}
+	}
+#endif
+
+	for (; i < count; ++i) {
+		if (circle_vs_segment(ax[i], ay[i], bx[i], by[i], cx, cy, radius, out[written])) {
+			out[written++].segment = i;
+		}
+	}
+	return written;
+}
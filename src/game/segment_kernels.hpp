@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+
+namespace game {
+	struct segment_contact {
+		int32_t segment; // index into the arrays given to the test.
+		float x, y; // contact point on the segment.
+		float normal_x, normal_y; // pointing from the segment towards the circle.
+		float depth;
+	};
+
+	// circle against segments from a[i] to b[i], four segments per step with sse2. the front of a segment is
+	// its left side, so a surface running left to right faces up. a segment is in contact when the circle overlaps
+	// it from the front, or when the center has sunk behind the segment but is still within its span.
+	// with a zero radius this is the polygon vertex against edge test.
+	// out must have room for count contacts. returns the number of contacts written, in segment order.
+	int32_t circle_vs_segments(
+		const float* ax, const float* ay, const float* bx, const float* by, int32_t count,
+		float cx, float cy, float radius, segment_contact* out);
+
+	// one segment at a time. same results as circle_vs_segments, kept as a reference for benchmarks.
+	int32_t circle_vs_segments_scalar(
+		const float* ax, const float* ay, const float* bx, const float* by, int32_t count,
+		float cx, float cy, float radius, segment_contact* out);
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GAME_SSE2 1
+#include <emmintrin.h>
+#else
+#define GAME_SSE2 0
+#endif
+
+#include <cstdint>
+
+namespace game {
+	namespace simd {
+#if GAME_SSE2
+		// sin and cos of four floats at once. cephes style range reduction to [-pi/4, pi/4]
+		// followed by minimax polynomials, accurate to a couple of ulps for game sized arguments.
+		inline void sincos4(__m128 x, __m128& s, __m128& c) {
+			const __m128 sign_mask = _mm_castsi128_ps(_mm_set1_epi32(int32_t(0x80000000)));
+			
+			__m128 sign_bit_sin = _mm_and_ps(x, sign_mask);
+			x = _mm_andnot_ps(sign_mask, x);
+
+			// quadrant index, rounded to even.
+			__m128i j = _mm_cvttps_epi32(_mm_mul_ps(x, _mm_set1_ps(1.27323954473516f)));
+			j = _mm_add_epi32(j, _mm_set1_epi32(1));
+			j = _mm_and_si128(j, _mm_set1_epi32(~1));
+			__m128 y = _mm_cvtepi32_ps(j);
+
+			__m128 swap_sign_bit_sin = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(j, _mm_set1_epi32(4)), 29));
+			__m128 poly_mask = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(j, _mm_set1_epi32(2)), _mm_setzero_si128()));
+			__m128 sign_bit_cos = _mm_castsi128_ps(_mm_slli_epi32(_mm_andnot_si128(_mm_sub_epi32(j, _mm_set1_epi32(2)), _mm_set1_epi32(4)), 29));
+			sign_bit_sin = _mm_xor_ps(sign_bit_sin, swap_sign_bit_sin);
+
+			// extended precision modular arithmetic: x = ((x - y * dp1) - y * dp2) - y * dp3
+			x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(0.78515625f)));
+			x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(2.4187564849853515625e-4f)));
+			x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(3.77489497744594108e-8f)));
+
+			__m128 z = _mm_mul_ps(x, x);
+
+			__m128 poly_cos = _mm_set1_ps(2.443315711809948e-5f);
+			poly_cos = _mm_add_ps(_mm_mul_ps(poly_cos, z), _mm_set1_ps(-1.388731625493765e-3f));
+			poly_cos = _mm_add_ps(_mm_mul_ps(poly_cos, z), _mm_set1_ps(4.166664568298827e-2f));
+			poly_cos = _mm_mul_ps(_mm_mul_ps(poly_cos, z), z);
+			poly_cos = _mm_sub_ps(poly_cos, _mm_mul_ps(z, _mm_set1_ps(0.5f)));
+			poly_cos = _mm_add_ps(poly_cos, _mm_set1_ps(1.0f));
+
+			__m128 poly_sin = _mm_set1_ps(-1.9515295891e-4f);
+			poly_sin = _mm_add_ps(_mm_mul_ps(poly_sin, z), _mm_set1_ps(8.3321608736e-3f));
+			poly_sin = _mm_add_ps(_mm_mul_ps(poly_sin, z), _mm_set1_ps(-1.6666654611e-1f));
+			poly_sin = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(poly_sin, z), x), x);
+
+			__m128 sin_value = _mm_or_ps(_mm_and_ps(poly_mask, poly_sin), _mm_andnot_ps(poly_mask, poly_cos));
+			__m128 cos_value = _mm_or_ps(_mm_andnot_ps(poly_mask, poly_sin), _mm_and_ps(poly_mask, poly_cos));
+
+			s = _mm_xor_ps(sin_value, sign_bit_sin);
+			c = _mm_xor_ps(cos_value, sign_bit_cos);
+		}
+#endif
+	}
+}
@@ -0,0 +1,439 @@
+
+#include <game/spring_joints.hpp>
+#include <game/simd_math.hpp>
+
+#include <rynx/scheduler/context.hpp>
+#include <rynx/tech/profiling.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+	constexpr int32_t lanes = 4;
+
+#if !GAME_SSE2
+	// geometry of a single joint, for targets without sse2.
+	inline void prepare_joint(
+		float ax, float ay, float bx, float by,
+		float rax, float ray, float rbx, float rby,
+		float ima, float iia, float imb, float iib,
+		float rest_length, float rate, float scale, float one_sided,
+		float& nx, float& ny, float& cross_a, float& cross_b, float& inv_k, float& bias, float& length)
+	{
+		const float dx = (ax + rax) - (bx + rbx);
+		const float dy = (ay + ray) - (by + rby);
+		length = std::sqrt(dx * dx + dy * dy);
+
+		const float inv_length = (length > 1e-6f) ? 1.0f / length : 0.0f;
+		nx = dx * inv_length;
+		ny = dy * inv_length;
+		cross_a = rax * ny - ray * nx;
+		cross_b = rbx * ny - rby * nx;
+
+		// a rubber band goes slack when it is not stretched.
+		const bool active = (one_sided == 0.0f) || (length > rest_length);
+		const float k = ima + imb + iia * cross_a * cross_a + iib * cross_b * cross_b;
+		inv_k = (active && k > 0.0f) ? scale / k : 0.0f;
+		bias = rate * (length - rest_length);
+	}
+#endif
+}
+
+void game::spring_joints::bodies::clear() {
+	motion.clear();
+	pose.clear();
+	transform.clear();
+	velocity.clear();
+	inv_mass.clear();
+	inv_inertia.clear();
+	next_batch.clear();
+}
+
+// one sin and cos per body, four bodies at a time where sse2 is available.
+void game::spring_joints::bodies::build_transforms() {
+	transform.resize(pose.size());
+	size_t i = 0;
+#if GAME_SSE2
+	for (; i + lanes <= pose.size(); i += lanes) {
+		alignas(16) float angle[lanes], sin_angle[lanes], cos_angle[lanes];
+		for (int32_t k = 0; k < lanes; ++k) {
+			angle[k] = pose[i + k].angle;
+		}
+
+		__m128 s, c;
+		game::simd::sincos4(_mm_load_ps(angle), s, c);
+		_mm_store_ps(sin_angle, s);
+		_mm_store_ps(cos_angle, c);
+		for (int32_t k = 0; k < lanes; ++k) {
+			transform[i + k] = game::affine2d::from(pose[i + k], sin_angle[k], cos_angle[k]);
+		}
+	}
+#endif
+	for (; i < pose.size(); ++i) {
+		transform[i] = game::affine2d::from(pose[i]);
+	}
+}
+
+void game::spring_joints::joints::clear() {
+	body_a.clear();
+	body_b.clear();
+	lanes_used.clear();
+	for (auto* v : {
+		&pax, &pay, &pbx, &pby,
+		&ax, &ay, &bx, &by, &rax, &ray, &rbx, &rby,
+		&inv_mass_a, &inv_inertia_a, &inv_mass_b, &inv_inertia_b,
+		&rest_length, &rate, &scale, &one_sided,
+		&nx, &ny, &cross_a, &cross_b, &inv_k, &bias, &upper, &length,
+		&angular_inv_k, &angular_bias,
+		&impulse, &angular_impulse })
+	{
+		v->clear();
+	}
+	count = 0;
+}
+
+void game::spring_joints::joints::add_batch() {
+	lanes_used.emplace_back(0);
+	body_a.resize(body_a.size() + lanes, -1);
+	body_b.resize(body_b.size() + lanes, -1);
+	for (auto* v : {
+		&pax, &pay, &pbx, &pby,
+		&ax, &ay, &bx, &by, &rax, &ray, &rbx, &rby,
+		&inv_mass_a, &inv_inertia_a, &inv_mass_b, &inv_inertia_b,
+		&rest_length, &rate, &scale, &one_sided,
+		&nx, &ny, &cross_a, &cross_b, &inv_k, &bias, &upper, &length,
+		&angular_inv_k, &angular_bias,
+		&impulse, &angular_impulse })
+	{
+		v->resize(v->size() + lanes, 0.0f);
+	}
+}
+
+// first batch after the previous joints of both bodies that still has a free lane.
+// joints of one body land in increasing batches, so their solve order is kept.
+int32_t game::spring_joints::pack(int32_t a, int32_t b) {
+	int32_t batch = std::max(m_bodies.next_batch[a], m_bodies.next_batch[b]);
+	while (batch < m_joints.batch_count() && m_joints.lanes_used[batch] == lanes) {
+		++batch;
+	}
+	if (batch == m_joints.batch_count()) {
+		m_joints.add_batch();
+	}
+
+	m_bodies.next_batch[a] = batch + 1;
+	m_bodies.next_batch[b] = batch + 1;
+	++m_joints.count;
+	return batch * lanes + m_joints.lanes_used[batch]++;
+}
+
+void game::spring_joints::onFrameProcess(rynx::scheduler::context& context, float dt) {
+	context.add_task("spring joints", [this, dt](
+		rynx::ecs::view<
+			const rynx::components::phys::joint,
+			const rynx::components::position,
+			const rynx::components::physical_body,
+			rynx::components::motion> ecs)
+	{
+		rynx_profile("Game", "spring joints");
+
+		m_body_index.clear();
+		m_bodies.clear();
+		m_joints.clear();
+
+		auto body_slot = [&](rynx::ecs::id id) -> int32_t {
+			auto it = m_body_index.find(id.value);
+			if (it != m_body_index.end()) {
+				return it->second;
+			}
+
+			int32_t slot = -1;
+			if (ecs.exists(id)) {
+				auto entity = ecs[id];
+				const auto* pos = entity.try_get<const rynx::components::position>();
+				auto* mot = entity.try_get<rynx::components::motion>();
+				const auto* body = entity.try_get<const rynx::components::physical_body>();
+				if (pos && mot && body) {
+					slot = m_bodies.size();
+					m_bodies.motion.emplace_back(mot);
+					m_bodies.pose.emplace_back(game::pose2d::from(*pos));
+					m_bodies.velocity.emplace_back(game::velocity2d::from(*mot));
+					m_bodies.inv_mass.emplace_back(body->inv_mass);
+					m_bodies.inv_inertia.emplace_back(body->inv_moment_of_inertia);
+					m_bodies.next_batch.emplace_back(0);
+				}
+			}
+
+			m_body_index.emplace(id.value, slot);
+			return slot;
+		};
+
+		using joint_t = rynx::components::phys::joint;
+		std::unordered_map<uint64_t, float> rest_angles;
+		auto gather = [&](rynx::ecs::id id, const joint_t& j) {
+			const int32_t a = body_slot(j.id_a);
+			const int32_t b = body_slot(j.id_b);
+			if (a < 0 || b < 0 || a == b) {
+				return;
+			}
+
+			auto& J = m_joints;
+			const int32_t i = pack(a, b);
+			const auto& pose_a = m_bodies.pose[a];
+			const auto& pose_b = m_bodies.pose[b];
+
+			J.body_a[i] = a;
+			J.body_b[i] = b;
+			J.pax[i] = j.point_a.x;
+			J.pay[i] = j.point_a.y;
+			J.pbx[i] = j.point_b.x;
+			J.pby[i] = j.point_b.y;
+			J.inv_mass_a[i] = m_bodies.inv_mass[a];
+			J.inv_inertia_a[i] = m_bodies.inv_inertia[a];
+			J.inv_mass_b[i] = m_bodies.inv_mass[b];
+			J.inv_inertia_b[i] = m_bodies.inv_inertia[b];
+			J.rest_length[i] = j.length;
+			J.rate[i] = 1.0f / std::max(j.response_time, dt);
+			J.upper[i] = std::numeric_limits<float>::max();
+
+			const bool rigid = j.connector == joint_t::connector_type::RigidConnection;
+			const float soft_scale = j.strength / (1.0f + j.softness);
+			switch (j.connector) {
+				case joint_t::connector_type::RigidConnection:
+					J.scale[i] = 1.0f;
+					break;
+				case joint_t::connector_type::SpringConnection:
+					J.scale[i] = soft_scale;
+					break;
+				case joint_t::connector_type::RubberBandConnection:
+					J.scale[i] = soft_scale;
+					J.one_sided[i] = 1.0f;
+					J.upper[i] = 0.0f;
+					break;
+				default:
+					J.scale[i] = 0.0f;
+					break;
+			}
+
+			if (j.rotation == joint_t::rotation_type::LockedRotation) {
+				const float relative_angle = pose_b.angle - pose_a.angle;
+				auto it = m_rest_angles.find(id.value);
+				const float rest_angle = (it != m_rest_angles.end()) ? it->second : relative_angle;
+				rest_angles.emplace(id.value, rest_angle);
+
+				const float inertia = J.inv_inertia_a[i] + J.inv_inertia_b[i];
+				J.angular_inv_k[i] = (inertia > 0.0f) ? (rigid ? 1.0f : soft_scale) / inertia : 0.0f;
+				J.angular_bias[i] = J.rate[i] * (relative_angle - rest_angle);
+			}
+		};
+
+		ecs.query().for_each([&](rynx::ecs::id id, const joint_t& j) { gather(id, j); });
+
+		// forget the rest angles of joints that no longer exist.
+		m_rest_angles.swap(rest_angles);
+
+		if (m_joints.count == 0) {
+			return;
+		}
+
+		m_bodies.build_transforms();
+		place_anchors();
+		prepare();
+		for (int32_t iteration = 0; iteration < m_iterations; ++iteration) {
+			solve_iteration();
+		}
+
+		for (int32_t i = 0; i < m_bodies.size(); ++i) {
+			auto& mot = *m_bodies.motion[i];
+			const auto& velocity = m_bodies.velocity[i];
+			mot.velocity.x = velocity.linear.x;
+			mot.velocity.y = velocity.linear.y;
+			mot.angularVelocity = velocity.angular;
+		}
+	});
+}
+
+// body centers and world space offsets of the anchor points. unused lanes stay at zero.
+void game::spring_joints::place_anchors() {
+	auto& J = m_joints;
+	for (int32_t batch = 0; batch < J.batch_count(); ++batch) {
+		for (int32_t lane = 0; lane < J.lanes_used[batch]; ++lane) {
+			const int32_t i = batch * lanes + lane;
+			const auto& transform_a = m_bodies.transform[J.body_a[i]];
+			const auto& transform_b = m_bodies.transform[J.body_b[i]];
+			const game::vec2 ra = transform_a.rotate({ J.pax[i], J.pay[i] });
+			const game::vec2 rb = transform_b.rotate({ J.pbx[i], J.pby[i] });
+
+			J.ax[i] = transform_a.translation.x;
+			J.ay[i] = transform_a.translation.y;
+			J.bx[i] = transform_b.translation.x;
+			J.by[i] = transform_b.translation.y;
+			J.rax[i] = ra.x;
+			J.ray[i] = ra.y;
+			J.rbx[i] = rb.x;
+			J.rby[i] = rb.y;
+		}
+	}
+}
+
+void game::spring_joints::prepare() {
+	auto& J = m_joints;
+	const int32_t padded = J.batch_count() * lanes;
+
+#if GAME_SSE2
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 epsilon = _mm_set1_ps(1e-6f);
+
+	for (int32_t i = 0; i < padded; i += lanes) {
+		const __m128 rax = _mm_loadu_ps(&J.rax[i]);
+		const __m128 ray = _mm_loadu_ps(&J.ray[i]);
+		const __m128 rbx = _mm_loadu_ps(&J.rbx[i]);
+		const __m128 rby = _mm_loadu_ps(&J.rby[i]);
+
+		const __m128 dx = _mm_sub_ps(_mm_add_ps(_mm_loadu_ps(&J.ax[i]), rax), _mm_add_ps(_mm_loadu_ps(&J.bx[i]), rbx));
+		const __m128 dy = _mm_sub_ps(_mm_add_ps(_mm_loadu_ps(&J.ay[i]), ray), _mm_add_ps(_mm_loadu_ps(&J.by[i]), rby));
+		const __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)));
+
+		const __m128 valid_length = _mm_cmpgt_ps(length, epsilon);
+		const __m128 inv_length = _mm_and_ps(valid_length, _mm_div_ps(one, _mm_max_ps(length, epsilon)));
+		const __m128 nx = _mm_mul_ps(dx, inv_length);
+		const __m128 ny = _mm_mul_ps(dy, inv_length);
+		const __m128 cross_a = _mm_sub_ps(_mm_mul_ps(rax, ny), _mm_mul_ps(ray, nx));
+		const __m128 cross_b = _mm_sub_ps(_mm_mul_ps(rbx, ny), _mm_mul_ps(rby, nx));
+
+		__m128 k = _mm_add_ps(_mm_loadu_ps(&J.inv_mass_a[i]), _mm_loadu_ps(&J.inv_mass_b[i]));
+		k = _mm_add_ps(k, _mm_mul_ps(_mm_loadu_ps(&J.inv_inertia_a[i]), _mm_mul_ps(cross_a, cross_a)));
+		k = _mm_add_ps(k, _mm_mul_ps(_mm_loadu_ps(&J.inv_inertia_b[i]), _mm_mul_ps(cross_b, cross_b)));
+
+		// a rubber band goes slack when it is not stretched.
+		const __m128 rest_length = _mm_loadu_ps(&J.rest_length[i]);
+		const __m128 active = _mm_or_ps(_mm_cmpeq_ps(_mm_loadu_ps(&J.one_sided[i]), zero), _mm_cmpgt_ps(length, rest_length));
+		const __m128 valid_k = _mm_and_ps(active, _mm_cmpgt_ps(k, zero));
+		const __m128 inv_k = _mm_and_ps(valid_k, _mm_div_ps(_mm_loadu_ps(&J.scale[i]), _mm_max_ps(k, epsilon)));
+		const __m128 bias = _mm_mul_ps(_mm_loadu_ps(&J.rate[i]), _mm_sub_ps(length, rest_length));
+
+		_mm_storeu_ps(&J.nx[i], nx);
+		_mm_storeu_ps(&J.ny[i], ny);
+		_mm_storeu_ps(&J.cross_a[i], cross_a);
+		_mm_storeu_ps(&J.cross_b[i], cross_b);
+		_mm_storeu_ps(&J.inv_k[i], inv_k);
+		_mm_storeu_ps(&J.bias[i], bias);
+		_mm_storeu_ps(&J.length[i], length);
+	}
+#else
+	for (int32_t i = 0; i < padded; ++i) {
+		prepare_joint(
+			J.ax[i], J.ay[i], J.bx[i], J.by[i],
+			J.rax[i], J.ray[i], J.rbx[i], J.rby[i],
+			J.inv_mass_a[i], J.inv_inertia_a[i], J.inv_mass_b[i], J.inv_inertia_b[i],
+			J.rest_length[i], J.rate[i], J.scale[i], J.one_sided[i],
+			J.nx[i], J.ny[i], J.cross_a[i], J.cross_b[i], J.inv_k[i], J.bias[i], J.length[i]);
+	}
+#endif
+}
+
+void game::spring_joints::solve_iteration() {
+	auto& J = m_joints;
+	auto& B = m_bodies;
+
+	for (int32_t batch = 0; batch < J.batch_count(); ++batch) {
+		const int32_t first = batch * lanes;
+		alignas(16) float vax[lanes] = {}, vay[lanes] = {}, wa[lanes] = {};
+		alignas(16) float vbx[lanes] = {}, vby[lanes] = {}, wb[lanes] = {};
+
+		// the lanes of a batch never share a body, so the velocities can be gathered and written back lane by lane.
+		for (int32_t lane = 0; lane < J.lanes_used[batch]; ++lane) {
+			const auto& va = B.velocity[J.body_a[first + lane]];
+			const auto& vb = B.velocity[J.body_b[first + lane]];
+			vax[lane] = va.linear.x;
+			vay[lane] = va.linear.y;
+			wa[lane] = va.angular;
+			vbx[lane] = vb.linear.x;
+			vby[lane] = vb.linear.y;
+			wb[lane] = vb.angular;
+		}
+
+#if GAME_SSE2
+		__m128 va_x = _mm_load_ps(vax);
+		__m128 va_y = _mm_load_ps(vay);
+		__m128 w_a = _mm_load_ps(wa);
+		__m128 vb_x = _mm_load_ps(vbx);
+		__m128 vb_y = _mm_load_ps(vby);
+		__m128 w_b = _mm_load_ps(wb);
+
+		const __m128 nx = _mm_loadu_ps(&J.nx[first]);
+		const __m128 ny = _mm_loadu_ps(&J.ny[first]);
+		const __m128 cross_a = _mm_loadu_ps(&J.cross_a[first]);
+		const __m128 cross_b = _mm_loadu_ps(&J.cross_b[first]);
+		const __m128 ima = _mm_loadu_ps(&J.inv_mass_a[first]);
+		const __m128 iia = _mm_loadu_ps(&J.inv_inertia_a[first]);
+		const __m128 imb = _mm_loadu_ps(&J.inv_mass_b[first]);
+		const __m128 iib = _mm_loadu_ps(&J.inv_inertia_b[first]);
+
+		// impulse = -(separation velocity + bias) * inv_k, accumulated impulse clamped to upper.
+		{
+			__m128 separation_velocity = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(va_x, vb_x), nx), _mm_mul_ps(_mm_sub_ps(va_y, vb_y), ny));
+			separation_velocity = _mm_add_ps(separation_velocity, _mm_sub_ps(_mm_mul_ps(w_a, cross_a), _mm_mul_ps(w_b, cross_b)));
+
+			const __m128 target = _mm_add_ps(separation_velocity, _mm_loadu_ps(&J.bias[first]));
+			const __m128 previous = _mm_loadu_ps(&J.impulse[first]);
+			const __m128 accumulated = _mm_min_ps(_mm_sub_ps(previous, _mm_mul_ps(target, _mm_loadu_ps(&J.inv_k[first]))), _mm_loadu_ps(&J.upper[first]));
+			const __m128 impulse = _mm_sub_ps(accumulated, previous);
+			_mm_storeu_ps(&J.impulse[first], accumulated);
+
+			const __m128 impulse_x = _mm_mul_ps(nx, impulse);
+			const __m128 impulse_y = _mm_mul_ps(ny, impulse);
+			va_x = _mm_add_ps(va_x, _mm_mul_ps(impulse_x, ima));
+			va_y = _mm_add_ps(va_y, _mm_mul_ps(impulse_y, ima));
+			w_a = _mm_add_ps(w_a, _mm_mul_ps(_mm_mul_ps(cross_a, impulse), iia));
+			vb_x = _mm_sub_ps(vb_x, _mm_mul_ps(impulse_x, imb));
+			vb_y = _mm_sub_ps(vb_y, _mm_mul_ps(impulse_y, imb));
+			w_b = _mm_sub_ps(w_b, _mm_mul_ps(_mm_mul_ps(cross_b, impulse), iib));
+		}
+
+		// angular impulse = (relative angular velocity + angular bias) * angular inv_k, zero for rotation free joints.
+		{
+			const __m128 target = _mm_add_ps(_mm_sub_ps(w_b, w_a), _mm_loadu_ps(&J.angular_bias[first]));
+			const __m128 impulse = _mm_mul_ps(target, _mm_loadu_ps(&J.angular_inv_k[first]));
+			_mm_storeu_ps(&J.angular_impulse[first], _mm_add_ps(_mm_loadu_ps(&J.angular_impulse[first]), impulse));
+			w_a = _mm_add_ps(w_a, _mm_mul_ps(impulse, iia));
+			w_b = _mm_sub_ps(w_b, _mm_mul_ps(impulse, iib));
+		}
+
+		_mm_store_ps(vax, va_x);
+		_mm_store_ps(vay, va_y);
+		_mm_store_ps(wa, w_a);
+		_mm_store_ps(vbx, vb_x);
+		_mm_store_ps(vby, vb_y);
+		_mm_store_ps(wb, w_b);
+#else
+		for (int32_t lane = 0; lane < lanes; ++lane) {
+			const int32_t i = first + lane;
+			float separation_velocity = (vax[lane] - vbx[lane]) * J.nx[i] + (vay[lane] - vby[lane]) * J.ny[i];
+			separation_velocity += wa[lane] * J.cross_a[i] - wb[lane] * J.cross_b[i];
+
+			const float previous = J.impulse[i];
+			J.impulse[i] = std::min(previous - (separation_velocity + J.bias[i]) * J.inv_k[i], J.upper[i]);
+			const float impulse = J.impulse[i] - previous;
+
+			vax[lane] += J.nx[i] * impulse * J.inv_mass_a[i];
+			vay[lane] += J.ny[i] * impulse * J.inv_mass_a[i];
+			wa[lane] += J.cross_a[i] * impulse * J.inv_inertia_a[i];
+			vbx[lane] -= J.nx[i] * impulse * J.inv_mass_b[i];
+			vby[lane] -= J.ny[i] * impulse * J.inv_mass_b[i];
+			wb[lane] -= J.cross_b[i] * impulse * J.inv_inertia_b[i];
+
+			const float angular_impulse = (wb[lane] - wa[lane] + J.angular_bias[i]) * J.angular_inv_k[i];
+			J.angular_impulse[i] += angular_impulse;
+			wa[lane] += angular_impulse * J.inv_inertia_a[i];
+			wb[lane] -= angular_impulse * J.inv_inertia_b[i];
+		}
+#endif
+
+		for (int32_t lane = 0; lane < J.lanes_used[batch]; ++lane) {
+			B.velocity[J.body_a[first + lane]] = { { vax[lane], vay[lane] }, wa[lane] };
+			B.velocity[J.body_b[first + lane]] = { { vbx[lane], vby[lane] }, wb[lane] };
+		}
+	}
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <game/transform2d.hpp>
+#include <rynx/application/logic.hpp>
+#include <rynx/tech/components.hpp>
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace game {
+	// solves rynx::components::phys::joint constraints, replacing rynx::ruleset::physics::springs.
+	// every connector type and rotation flag of the joint component is handled:
+	//   rod: holds the joint length rigidly, strength and softness are ignored.
+	//   spring: pulls and pushes towards the joint length, scaled by strength and softened by softness.
+	//   rubber band: a spring that only pulls, while stretched past the joint length.
+	//   free: no length constraint.
+	//   rotation locked: the relative angle of the two bodies is held at the angle they had when the solver first saw the joint.
+	//   rotation free: the bodies turn freely about the joint points.
+	// length and angle drift are corrected over response_time seconds.
+	//
+	// joints are packed into batches of four that touch eight distinct bodies, so that each batch is solved with sse2 and
+	// scattered back before the next one reads the body velocities. every joint is solved at full strength, in the same order
+	// as a joint by joint solver would. bodies are gathered as planar poses and velocities, and each body's sin and cos is
+	// computed once into a game::affine2d that places the anchor points of all of its joints.
+	//
+	// not used by the game yet. the bike is tuned against the engine solver, the bench compares the two (compare_joint_solvers)
+	// and the game switches over once trajectories and timings match.
+	class spring_joints : public rynx::application::logic::iruleset {
+	public:
+		spring_joints(int32_t iterations = 4) : m_iterations(iterations) {}
+		virtual ~spring_joints() = default;
+		virtual void onFrameProcess(rynx::scheduler::context& context, float dt) override;
+
+	private:
+		struct bodies {
+			std::vector<rynx::components::motion*> motion;
+			std::vector<game::pose2d> pose;
+			std::vector<game::affine2d> transform;
+			std::vector<game::velocity2d> velocity;
+			std::vector<float> inv_mass;
+			std::vector<float> inv_inertia;
+			std::vector<int32_t> next_batch; // first batch this body is free in, while packing.
+
+			void clear();
+			void build_transforms();
+			int32_t size() const { return static_cast<int32_t>(pose.size()); }
+		};
+
+		// four lanes per batch. unused lanes have no bodies and zero inverse mass terms, which makes them inert.
+		struct joints {
+			std::vector<int32_t> body_a, body_b;
+			std::vector<int32_t> lanes_used; // per batch.
+
+			// gathered input. anchor points are local to their body until placed in world space.
+			std::vector<float> pax, pay, pbx, pby;
+			std::vector<float> ax, ay, bx, by, rax, ray, rbx, rby;
+			std::vector<float> inv_mass_a, inv_inertia_a, inv_mass_b, inv_inertia_b;
+			std::vector<float> rest_length, rate, scale, one_sided;
+
+			// solver state, computed once per frame.
+			std::vector<float> nx, ny, cross_a, cross_b, inv_k, bias, upper, length;
+			std::vector<float> angular_inv_k, angular_bias;
+
+			// accumulated over the iterations of a frame.
+			std::vector<float> impulse, angular_impulse;
+
+			void clear();
+			void add_batch();
+			int32_t batch_count() const { return static_cast<int32_t>(lanes_used.size()); }
+			int32_t count = 0;
+		};
+
+		int32_t pack(int32_t body_a, int32_t body_b);
+		void place_anchors();
+		void prepare();
+		void solve_iteration();
+
+		int32_t m_iterations;
+		std::unordered_map<uint64_t, int32_t> m_body_index;
+		std::unordered_map<uint64_t, float> m_rest_angles; // by joint entity, for rotation locked joints.
+		bodies m_bodies;
+		joints m_joints;
+	};
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <rynx/tech/components.hpp>
+
+#include <limits>
+
+namespace game {
+	// physical body for geometry that never moves, like terrain, level pieces and editor polygons.
+	// static entities are created without motion, so motion updates never integrate them, and they live in collision
+	// categories that are only tested with ignore_collisions() and refreshed by update_entity_forced when edited.
+	// inverse mass and inertia are exactly zero. 1 / float max would be a denormal, and every contact
+	// against the body would run its impulse math on denormals.
+	inline rynx::components::physical_body static_body(float friction = 1.0f, float elasticity = 0.0f) {
+		rynx::components::physical_body body = rynx::components::physical_body()
+			.mass(std::numeric_limits<float>::max())
+			.friction(friction)
+			.elasticity(elasticity)
+			.moment_of_inertia(std::numeric_limits<float>::max());
+		body.inv_mass = 0.0f;
+		body.inv_moment_of_inertia = 0.0f;
+		return body;
+	}
+}
@@ -0,0 +1,115 @@
+
+#include <game/strip_mesh_builder.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+game::strip_mesh_builder::strip_mesh_builder(int32_t vertex_budget)
+	: m_vertex_budget(std::clamp(vertex_budget, 4, rynx_mesh_vertex_limit))
+{}
+
+int32_t game::strip_mesh_builder::num_parts(int32_t count) const {
+	const int32_t columns_per_part = m_vertex_budget / 2;
+	
+	// consecutive parts share one column.
+	int32_t result = 1;
+	if (count > columns_per_part) {
+		result += (count - columns_per_part + columns_per_part - 2) / (columns_per_part - 1);
+	}
+	return result;
+}
+
+const std::vector<game::strip_mesh_builder::part>& game::strip_mesh_builder::build(const rynx::vec3f* surface, const rynx::vec3f* normals, int32_t count) {
+	const int32_t columns_per_part = m_vertex_budget / 2;
+	const int32_t parts_needed = num_parts(count);
+
+	m_parts.resize(parts_needed);
+	for (int32_t i = 0; i < parts_needed; ++i) {
+		auto& p = m_parts[i];
+		p.first_column = i * (columns_per_part - 1);
+		p.num_columns = std::min(columns_per_part, count - p.first_column);
+		build_part(p, surface + p.first_column, normals + p.first_column);
+	}
+
+	return m_parts;
+}
+
+void game::strip_mesh_builder::build_part(part& p, const rynx::vec3f* surface, const rynx::vec3f* normals) const {
+	p.vertices.resize(6 * p.num_columns);
+	p.normals.resize(6 * p.num_columns);
+	p.texCoords.resize(4 * p.num_columns);
+
+	float* vertex_out = p.vertices.data();
+	float* normal_out = p.normals.data();
+	float* uv_out = p.texCoords.data();
+
+	for (int32_t i = 0; i < p.num_columns; ++i) {
+		const auto v = surface[i];
+		const auto n = normals[i];
+
+		// top vertex followed by bottom vertex.
+		*vertex_out++ = v.x;
+		*vertex_out++ = v.y;
+		*vertex_out++ = v.z;
+		*vertex_out++ = v.x;
+		*vertex_out++ = m_bottom;
+		*vertex_out++ = v.z;
+
+		*normal_out++ = n.x;
+		*normal_out++ = n.y;
+		*normal_out++ = n.z;
+		*normal_out++ = 0.0f;
+		*normal_out++ = -1.0f;
+		*normal_out++ = 0.0f;
+
+		// UVs are total bullshit. TODO: fix.
+		*uv_out++ = m_uv_limits.x;
+		*uv_out++ = m_uv_limits.y;
+		*uv_out++ = m_uv_limits.z;
+		*uv_out++ = m_uv_limits.w;
+	}
+
+	write_indices(p.indices, p.num_columns);
+}
+
+void game::strip_mesh_builder::write_indices(std::vector<uint16_t>& indices, int32_t num_columns) {
+	indices.resize(6 * std::max(num_columns - 1, 0));
+	uint16_t* out = indices.data();
+	for (int32_t i = 1; i < num_columns; ++i) {
+		const uint16_t top_left = static_cast<uint16_t>(2 * i - 2);
+		const uint16_t bottom_left = static_cast<uint16_t>(2 * i - 1);
+		const uint16_t top_right = static_cast<uint16_t>(2 * i);
+		const uint16_t bottom_right = static_cast<uint16_t>(2 * i + 1);
+
+		// counter clockwise when surface runs along +x.
+		*out++ = top_left;
+		*out++ = bottom_left;
+		*out++ = top_right;
+
+		*out++ = top_right;
+		*out++ = bottom_left;
+		*out++ = bottom_right;
+	}
+}
+
+void game::strip_mesh_builder::write(const part& p, rynx::graphics::mesh& target) {
+	// checked in release builds too. indices past the limit would wrap around in the 16 bit signed index buffer.
+	if (p.num_vertices() > rynx_mesh_vertex_limit) {
+		std::fprintf(stderr, "strip mesh part has %d vertices, rynx meshes can index at most %d\n", p.num_vertices(), rynx_mesh_vertex_limit);
+		std::abort();
+	}
+
+	target.vertices.assign(p.vertices.begin(), p.vertices.end());
+	target.normals.assign(p.normals.begin(), p.normals.end());
+	target.texCoords.assign(p.texCoords.begin(), p.texCoords.end());
+	target.indices.assign(p.indices.begin(), p.indices.end());
+}
+
+#ifndef GAME_HEADLESS
+std::unique_ptr<rynx::graphics::mesh> game::strip_mesh_builder::make_mesh(const part& p) {
+	auto m = std::make_unique<rynx::graphics::mesh>();
+	write(p, *m);
+	return m;
+}
+#endif
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <rynx/math/vector.hpp>
+#include <rynx/graphics/mesh/mesh.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace game {
+	// builds meshes that fill the area between a surface line and a flat bottom, one quad per pair of
+	// adjacent surface points. all buffers are sized up front. surfaces that do not fit the vertex budget
+	// are split to several parts that share their edge column, so there are no gaps between them.
+	class strip_mesh_builder {
+	public:
+		// rynx::graphics::mesh uses 16 bit signed indices.
+		static constexpr int32_t rynx_mesh_vertex_limit = 32768;
+
+		struct part {
+			int32_t first_column = 0;
+			int32_t num_columns = 0;
+
+			std::vector<float> vertices;
+			std::vector<float> normals;
+			std::vector<float> texCoords;
+			std::vector<uint16_t> indices; // always below rynx_mesh_vertex_limit.
+
+			int32_t num_vertices() const { return 2 * num_columns; }
+		};
+
+		// the budget is clamped to rynx_mesh_vertex_limit, larger surfaces are split to more parts.
+		strip_mesh_builder(int32_t vertex_budget = rynx_mesh_vertex_limit);
+
+		strip_mesh_builder& bottom(float y) { m_bottom = y; return *this; }
+		strip_mesh_builder& uv_limits(rynx::floats4 limits) { m_uv_limits = limits; return *this; }
+
+
+		// surface points and bottom are expected in mesh space. storage from the previous build is reused.
+		const std::vector<part>& build(const rynx::vec3f* surface, const rynx::vec3f* normals, int32_t count);
+		const std::vector<part>& parts() const { return m_parts; }
+
+		// number of parts that a surface of count points is split to.
+		int32_t num_parts(int32_t count) const;
+
+		// copies a part to an existing mesh, resizing its buffers in place.
+		// aborts if the part does not fit the rynx index type, which only a part from outside the builder can do.
+		static void write(const part& p, rynx::graphics::mesh& target);
+		static std::unique_ptr<rynx::graphics::mesh> make_mesh(const part& p); // not in GAME_HEADLESS builds.
+
+	private:
+		void build_part(part& p, const rynx::vec3f* surface, const rynx::vec3f* normals) const;
+		static void write_indices(std::vector<uint16_t>& indices, int32_t num_columns);
+
+		int32_t m_vertex_budget;
+		float m_bottom = -1000.0f;
+		rynx::floats4 m_uv_limits;
+		std::vector<part> m_parts;
+	};
+}
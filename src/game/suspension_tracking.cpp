@@ -0,0 +1,53 @@
+#include <game/suspension_tracking.hpp>
+
+#include <rynx/scheduler/context.hpp>
+#include <rynx/tech/components.hpp>
+#include <rynx/tech/profiling.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+void game::suspension_tracking::onFrameProcess(rynx::scheduler::context& context, float dt) {
+	context.add_task("suspension tracking", [this, dt](
+		rynx::ecs::view<
+			const rynx::components::phys::joint,
+			const rynx::components::position,
+			const game::components::suspension,
+			game::components::suspension_state> ecs)
+	{
+		rynx_profile("Game", "suspension tracking");
+
+		auto state_of = [&](rynx::ecs::id id) -> game::components::suspension_state* {
+			return ecs.exists(id) ? ecs[id].try_get<game::components::suspension_state>() : nullptr;
+		};
+
+		// a vehicle has a handful of suspension joints, linear search is fine.
+		m_vehicles.clear();
+		ecs.query().in<game::components::suspension>().for_each([&](const rynx::components::phys::joint& j) {
+			auto* state = state_of(j.id_b);
+			state = state ? state : state_of(j.id_a);
+			if (!state) {
+				return;
+			}
+
+			auto it = std::find_if(m_vehicles.begin(), m_vehicles.end(), [state](const accumulator& a) { return a.state == state; });
+			if (it == m_vehicles.end()) {
+				it = m_vehicles.insert(m_vehicles.end(), accumulator{ state, 0.0f, 0 });
+			}
+
+			it->compression += j.length - rynx::components::phys::compute_current_joint_length(j, ecs);
+			++it->joint_count;
+		});
+
+		for (const auto& vehicle : m_vehicles) {
+			auto& state = *vehicle.state;
+
+			// first frame or changed joint setup has no meaningful previous value.
+			const bool continuous = (state.joint_count == vehicle.joint_count) && dt > 0.0f;
+			state.velocity = continuous ? (vehicle.compression - state.compression) / dt : 0.0f;
+			state.compression = vehicle.compression;
+			state.joint_count = vehicle.joint_count;
+			state.peak = std::max(std::abs(state.velocity), state.peak * std::max(0.0f, 1.0f - m_peak_decay * dt));
+		}
+	});
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <game/components.hpp>
+#include <rynx/application/logic.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace game {
+	// sums the joints tagged with game::components::suspension into the game::components::suspension_state found on
+	// either end of the joint, normally the vehicle body the wheels hold up. only reads the joints, so it works with
+	// whichever solver moves them. should run after the joint solver.
+	class suspension_tracking : public rynx::application::logic::iruleset {
+	public:
+		suspension_tracking(float peak_decay = 2.0f) : m_peak_decay(peak_decay) {}
+		virtual ~suspension_tracking() = default;
+		virtual void onFrameProcess(rynx::scheduler::context& context, float dt) override;
+
+	private:
+		struct accumulator {
+			game::components::suspension_state* state;
+			float compression;
+			int32_t joint_count;
+		};
+
+		float m_peak_decay; // per second.
+		std::vector<accumulator> m_vehicles;
+	};
+}
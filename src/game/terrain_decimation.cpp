@@ -0,0 +1,54 @@
+
+#include <game/terrain_decimation.hpp>
+
+#include <cmath>
+#include <utility>
+
+void game::decimate_terrain(const rynx::vec3f* points, int32_t count, float max_deviation, std::vector<int32_t>& kept) {
+	kept.clear();
+	if (count <= 2 || max_deviation <= 0.0f) {
+		for (int32_t i = 0; i < count; ++i) {
+			kept.emplace_back(i);
+		}
+		return;
+	}
+
+	// douglas-peucker, with an explicit stack instead of recursion.
+	std::vector<char> keep(count, 0);
+	keep[0] = 1;
+	keep[count - 1] = 1;
+
+	std::vector<std::pair<int32_t, int32_t>> ranges;
+	ranges.emplace_back(0, count - 1);
+
+	while (!ranges.empty()) {
+		auto [first, last] = ranges.back();
+		ranges.pop_back();
+
+		const rynx::vec3f a = points[first];
+		const rynx::vec3f b = points[last];
+		const float slope = (b.y - a.y) / (b.x - a.x);
+
+		float worst_deviation = max_deviation;
+		int32_t worst_index = -1;
+		for (int32_t i = first + 1; i < last; ++i) {
+			float deviation = std::abs(points[i].y - (a.y + (points[i].x - a.x) * slope));
+			if (deviation > worst_deviation) {
+				worst_deviation = deviation;
+				worst_index = i;
+			}
+		}
+
+		if (worst_index != -1) {
+			keep[worst_index] = 1;
+			ranges.emplace_back(first, worst_index);
+			ranges.emplace_back(worst_index, last);
+		}
+	}
+
+	for (int32_t i = 0; i < count; ++i) {
+		if (keep[i]) {
+			kept.emplace_back(i);
+		}
+	}
+}
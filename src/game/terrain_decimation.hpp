@@ -0,0 +1,14 @@
+#pragma once
+
+#include <rynx/math/vector.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace game {
+	// picks the surface points that are needed to keep the terrain within max_deviation of the original.
+	// points must be ordered by x. deviation is measured vertically, so that the result is also a valid
+	// height profile for anything resting on it. first and last point are always kept, which keeps
+	// neighbouring chunks connected. writes indices of kept points to `kept` in increasing order.
+	void decimate_terrain(const rynx::vec3f* points, int32_t count, float max_deviation, std::vector<int32_t>& kept);
+}
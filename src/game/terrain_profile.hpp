@@ -0,0 +1,48 @@
+#pragma once
+
+#include <rynx/math/vector.hpp>
+#include <cmath>
+
+namespace game {
+	// terrain surface is a sum of sine waves.
+	struct terrain_wave {
+		float amplitude;
+		float frequency;
+	};
+
+	constexpr terrain_wave terrain_waves[] = {
+		{ 250.0f, 0.0017f },
+		{ 110.0f, 0.0073f },
+		{ 50.0f, 0.013f }
+	};
+
+	constexpr float terrain_base_height = -100.0f;
+
+	// procedural height of the terrain surface at world x.
+	inline float terrain_height(float x) {
+		float y = 0.0f;
+		for (const auto& wave : terrain_waves) {
+			y += wave.amplitude * std::sin(x * wave.frequency);
+		}
+		return y + terrain_base_height;
+	}
+
+	// analytic derivative of terrain_height.
+	inline float terrain_slope(float x) {
+		float dydx = 0.0f;
+		for (const auto& wave : terrain_waves) {
+			dydx += wave.amplitude * wave.frequency * std::cos(x * wave.frequency);
+		}
+		return dydx;
+	}
+
+	// unit normal pointing up from a surface with the given slope.
+	inline rynx::vec3f terrain_normal_from_slope(float slope) {
+		float inv_length = 1.0f / std::sqrt(slope * slope + 1.0f);
+		return rynx::vec3f(-slope * inv_length, inv_length, 0.0f);
+	}
+
+	inline rynx::vec3f terrain_normal(float x) {
+		return terrain_normal_from_slope(terrain_slope(x));
+	}
+}
@@ -0,0 +1,94 @@
+
+#include <game/terrain_sampler.hpp>
+#include <game/terrain_profile.hpp>
+#include <game/simd_math.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+#if GAME_SSE2
+	inline void sample4(__m128 x, __m128& height, __m128& slope) {
+		height = _mm_set1_ps(game::terrain_base_height);
+		slope = _mm_setzero_ps();
+		for (const auto& wave : game::terrain_waves) {
+			__m128 s, c;
+			game::simd::sincos4(_mm_mul_ps(x, _mm_set1_ps(wave.frequency)), s, c);
+			height = _mm_add_ps(height, _mm_mul_ps(s, _mm_set1_ps(wave.amplitude)));
+			slope = _mm_add_ps(slope, _mm_mul_ps(c, _mm_set1_ps(wave.amplitude * wave.frequency)));
+		}
+	}
+
+	// runs op on blocks of four x values. the last partial block is padded, so that every
+	// sample goes through the same code path and adjacent chunks agree on shared samples.
+	template<typename XSource, typename Op>
+	void for_each_block(int32_t count, XSource&& x_source, Op&& op) {
+		alignas(16) float x_block[4];
+		alignas(16) float height_block[4];
+		alignas(16) float slope_block[4];
+		
+		for (int32_t i = 0; i < count; i += 4) {
+			int32_t lanes = std::min(4, count - i);
+			for (int32_t k = 0; k < 4; ++k) {
+				x_block[k] = x_source(i + std::min(k, lanes - 1));
+			}
+
+			__m128 height, slope;
+			sample4(_mm_load_ps(x_block), height, slope);
+			_mm_store_ps(height_block, height);
+			_mm_store_ps(slope_block, slope);
+			op(i, lanes, x_block, height_block, slope_block);
+		}
+	}
+#else
+	template<typename XSource, typename Op>
+	void for_each_block(int32_t count, XSource&& x_source, Op&& op) {
+		float x_block[4];
+		float height_block[4];
+		float slope_block[4];
+
+		for (int32_t i = 0; i < count; i += 4) {
+			int32_t lanes = std::min(4, count - i);
+			for (int32_t k = 0; k < lanes; ++k) {
+				x_block[k] = x_source(i + k);
+				height_block[k] = game::terrain_height(x_block[k]);
+				slope_block[k] = game::terrain_slope(x_block[k]);
+			}
+			op(i, lanes, x_block, height_block, slope_block);
+		}
+	}
+#endif
+
+	struct write_heights_and_slopes {
+		float* heights;
+		float* slopes;
+
+		void operator()(int32_t i, int32_t lanes, const float*, const float* height_block, const float* slope_block) const {
+			std::copy(height_block, height_block + lanes, heights + i);
+			if (slopes) {
+				std::copy(slope_block, slope_block + lanes, slopes + i);
+			}
+		}
+	};
+}
+
+void game::sample_terrain(const float* x, float* heights, float* slopes, int32_t count) {
+	for_each_block(count, [x](int32_t i) { return x[i]; }, write_heights_and_slopes{ heights, slopes });
+}
+
+void game::sample_terrain(float x_begin, float spacing, float* heights, float* slopes, int32_t count) {
+	for_each_block(count, [x_begin, spacing](int32_t i) { return x_begin + i * spacing; }, write_heights_and_slopes{ heights, slopes });
+}
+
+void game::sample_terrain_surface(float x_begin, float spacing, rynx::vec3f* positions, rynx::vec3f* normals, int32_t count) {
+	for_each_block(
+		count,
+		[x_begin, spacing](int32_t i) { return x_begin + i * spacing; },
+		[positions, normals](int32_t i, int32_t lanes, const float* x_block, const float* height_block, const float* slope_block) {
+			for (int32_t k = 0; k < lanes; ++k) {
+				positions[i + k] = rynx::vec3f(x_block[k], height_block[k], 0.0f);
+				normals[i + k] = game::terrain_normal_from_slope(slope_block[k]);
+			}
+		}
+	);
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <rynx/math/vector.hpp>
+#include <cstdint>
+
+namespace game {
+	// batch evaluation of game::terrain_height and game::terrain_slope, four samples at a time.
+	// output buffers must hold at least count values, slopes can be nullptr if not needed.
+	void sample_terrain(const float* x, float* heights, float* slopes, int32_t count);
+	
+	// same as above for evenly spaced x values x_begin + i * spacing.
+	void sample_terrain(float x_begin, float spacing, float* heights, float* slopes, int32_t count);
+
+	// writes surface positions and unit normals of evenly spaced samples directly to pre-sized buffers.
+	void sample_terrain_surface(float x_begin, float spacing, rynx::vec3f* positions, rynx::vec3f* normals, int32_t count);
+}
@@ -0,0 +1,246 @@
+
+#include <game/terrain_streaming.hpp>
+#include <game/terrain_sampler.hpp>
+#include <game/terrain_decimation.hpp>
+#include <game/height_field.hpp>
+#include <game/entity_builder.hpp>
+#include <game/static_body.hpp>
+
+#include <rynx/scheduler/context.hpp>
+#include <rynx/graphics/camera/camera.hpp>
+#include <rynx/tech/components.hpp>
+#include <rynx/application/components.hpp>
+#include <rynx/tech/profiling.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+
+namespace {
+	rynx::components::physical_body terrain_body() {
+		return game::static_body().bias(2.0f);
+	}
+}
+
+game::terrain_streaming::terrain_streaming(
+	rynx::graphics::mesh_collection& meshes,
+	rynx::graphics::GPUTextures& textures,
+	std::string terrainTexture,
+	rynx::collision_detection::category_id terrainCollisionCategory,
+	terrain_streaming_config config)
+	: m_meshes(&meshes)
+	, m_textures(&textures)
+	, m_texture(std::move(terrainTexture))
+	, m_collision_category(terrainCollisionCategory)
+	, m_config(config)
+{}
+
+game::terrain_streaming::terrain_streaming(
+	rynx::collision_detection::category_id terrainCollisionCategory,
+	terrain_streaming_config config)
+	: m_collision_category(terrainCollisionCategory)
+	, m_config(config)
+{}
+
+// note: chunk loading is done directly here instead of in a task, because new chunk meshes
+//       must be created on the thread that owns the gpu context. they are not in the renderer's
+//       prepared snapshot yet, unlike recycled meshes, which are refilled in upload_meshes().
+void game::terrain_streaming::onFrameProcess(rynx::scheduler::context& context, float /* dt */) {
+	rynx_profile("Game", "terrain streaming");
+	auto& ecs = context.get_resource<rynx::ecs>();
+	auto& detection = context.get_resource<rynx::collision_detection>();
+	const auto& changes = context.get_resource<game::transform_changes>();
+	auto& camera = context.get_resource<rynx::camera>();
+
+	int64_t camera_chunk = static_cast<int64_t>(std::floor((camera.position().x - m_config.track_begin) / m_config.chunk_width));
+	int64_t window_begin = std::max(int64_t(0), camera_chunk - m_config.chunks_behind);
+	int64_t window_end = std::max(int64_t(0), camera_chunk + m_config.chunks_ahead + 1);
+
+	if (window_begin == m_window_begin && window_end == m_window_end) {
+		return;
+	}
+
+	m_window_begin = window_begin;
+	m_window_end = window_end;
+
+	// evict chunks that are no longer in view.
+	for (auto& c : m_chunks) {
+		if (c.index < window_begin || c.index >= window_end) {
+			c.index = -1;
+		}
+	}
+
+	for (int64_t index = window_begin; index < window_end; ++index) {
+		bool loaded = false;
+		for (const auto& c : m_chunks) {
+			loaded |= (c.index == index);
+		}
+
+		if (loaded) {
+			continue;
+		}
+
+		chunk* target = nullptr;
+		for (auto& c : m_chunks) {
+			if (c.index == -1) {
+				target = &c;
+				break;
+			}
+		}
+
+		if (!target) {
+			target = &m_chunks.emplace_back();
+		}
+
+		load_chunk(ecs, detection, changes, *target, index);
+	}
+}
+
+void game::terrain_streaming::load_chunk(rynx::ecs& ecs, rynx::collision_detection& detection, const game::transform_changes& changes, chunk& c, int64_t index) {
+	const int32_t num_samples = static_cast<int32_t>(m_config.chunk_width / m_config.sample_spacing) + 1;
+	const float x_begin = m_config.track_begin + index * m_config.chunk_width;
+	const float x_end = x_begin + m_config.chunk_width;
+
+	game::components::height_field field;
+	field.x_begin = x_begin;
+	field.spacing = m_config.sample_spacing;
+
+	std::vector<rynx::vec3f> surface(num_samples);
+	std::vector<rynx::vec3f> normals(num_samples);
+	game::sample_terrain_surface(x_begin, m_config.sample_spacing, surface.data(), normals.data(), num_samples);
+	
+	field.heights.resize(num_samples);
+	for (int32_t i = 0; i < num_samples; ++i) {
+		field.heights[i] = surface[i].y;
+	}
+
+	// collision shape is kept local to the chunk center, so that the bounding sphere stays tight.
+	std::vector<int32_t> kept;
+	game::decimate_terrain(surface.data(), num_samples, m_config.collision_tolerance, kept);
+
+	std::vector<rynx::vec3f> outline(kept.size() + 2);
+	outline[0] = rynx::vec3f{ x_begin, m_config.bottom, 0.0f };
+	outline[1] = rynx::vec3f{ x_end, m_config.bottom, 0.0f };
+	for (size_t i = 0; i < kept.size(); ++i) {
+		outline[i + 2] = surface[kept[kept.size() - 1 - i]];
+	}
+	rynx::polygon shape(outline);
+
+	rynx::vec3f center = shape.bounding_sphere().first;
+	shape.edit().translate(-center);
+	shape.recompute_normals();
+	const float radius = shape.radius();
+
+	const bool recycled = c.created;
+	if (recycled) {
+		auto entity = ecs[c.entity];
+		entity.get<rynx::components::position>() = rynx::components::position(center, 0.0f);
+		entity.get<rynx::components::boundary>() = rynx::components::boundary(shape, center, 0.0f);
+		entity.get<rynx::components::radius>().r = radius;
+		entity.get<game::components::height_field>() = std::move(field);
+		detection.update_entity_forced(ecs, c.entity);
+		changes.mark(c.entity);
+	}
+	else if (!m_meshes) {
+		c.entity = ecs.create(
+			rynx::components::position(center, 0.0f),
+			rynx::components::collisions{ m_collision_category.value },
+			rynx::components::boundary(shape, center, 0.0f),
+			std::move(field),
+			rynx::components::radius(radius),
+			terrain_body(),
+			rynx::components::ignore_gravity(),
+			rynx::components::dampening{ 0.50f, 1.0f }
+		);
+		changes.mark(c.entity);
+	}
+
+#ifndef GAME_HEADLESS
+	if (m_meshes) {
+		game::decimate_terrain(surface.data(), num_samples, m_config.render_tolerance, kept);
+		
+		const float mesh_scale = 1.0f / radius;
+		std::vector<rynx::vec3f> mesh_surface(kept.size());
+		std::vector<rynx::vec3f> mesh_normals(kept.size());
+		for (size_t i = 0; i < kept.size(); ++i) {
+			mesh_surface[i] = (surface[kept[i]] - center) * mesh_scale;
+			mesh_normals[i] = normals[kept[i]];
+		}
+
+		const auto& parts = m_mesh_builder
+			.bottom((m_config.bottom - center.y) * mesh_scale)
+			.uv_limits(m_textures->textureLimits(m_texture))
+			.build(mesh_surface.data(), mesh_normals.data(), int32_t(mesh_surface.size()));
+
+		// every chunk gets as many meshes as its surface needs at full resolution. the decimated surface
+		// never needs more, and meshes past its last part are left empty.
+		static const game::strip_mesh_builder::part empty_part;
+		auto part_for_mesh = [&](size_t i) -> const game::strip_mesh_builder::part& { return (i < parts.size()) ? parts[i] : empty_part; };
+		
+		if (!recycled) {
+			const int32_t num_meshes = m_mesh_builder.num_parts(num_samples);
+			for (int32_t i = 0; i < num_meshes; ++i) {
+				std::string mesh_name = "terrain_chunk_" + std::to_string(m_chunks.size()) + "_" + std::to_string(i);
+				c.meshes.emplace_back(m_meshes->create(mesh_name, game::strip_mesh_builder::make_mesh(part_for_mesh(i)), "Empty"));
+			}
+
+			c.entity = ecs.create(
+				rynx::components::position(center, 0.0f),
+				rynx::components::collisions{ m_collision_category.value },
+				rynx::components::boundary(shape, center, 0.0f),
+				std::move(field),
+				rynx::components::mesh(c.meshes[0]),
+				rynx::matrix4(),
+				rynx::components::radius(radius),
+				rynx::components::color({ 0.2f, 1.0f, 0.3f, 1.0f }),
+				terrain_body(),
+				rynx::components::ignore_gravity(),
+				rynx::components::dampening{ 0.50f, 1.0f }
+			);
+			changes.mark(c.entity);
+
+			// surfaces that did not fit one mesh are drawn with render only entities sharing the chunk transform.
+			game::create_each(ecs, c.meshes.size() - 1, [&](size_t i) {
+				return std::make_tuple(
+					rynx::components::position(center, 0.0f),
+					rynx::components::mesh(c.meshes[i + 1]),
+					rynx::matrix4(),
+					rynx::components::radius(radius),
+					rynx::components::color({ 0.2f, 1.0f, 0.3f, 1.0f })
+				);
+			}, c.render_parts);
+		}
+		else {
+			for (size_t i = 0; i < c.meshes.size(); ++i) {
+				m_pending_uploads.emplace_back(pending_upload{ c.meshes[i], part_for_mesh(i) });
+			}
+
+			for (auto id : c.render_parts) {
+				auto part_entity = ecs[id];
+				part_entity.get<rynx::components::position>() = rynx::components::position(center, 0.0f);
+				part_entity.get<rynx::components::radius>().r = radius;
+				changes.mark(id);
+			}
+		}
+	}
+#endif
+
+	c.created = true;
+	c.index = index;
+}
+
+void game::terrain_streaming::upload_meshes() {
+	rynx_profile("Game", "terrain mesh uploads");
+
+#ifndef GAME_HEADLESS
+	// the decimated surface has a different number of points every time, so all buffers are uploaded at their new size.
+	for (const auto& upload : m_pending_uploads) {
+		game::strip_mesh_builder::write(upload.part, *upload.mesh);
+		upload.mesh->rebuildVertexBuffer();
+		upload.mesh->rebuildNormalBuffer();
+		upload.mesh->rebuildTextureBuffer();
+		upload.mesh->rebuildIndexBuffer();
+	}
+#endif
+	m_pending_uploads.clear();
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <rynx/application/logic.hpp>
+#include <rynx/tech/collision_detection.hpp>
+#include <rynx/math/geometry/polygon.hpp>
+#include <rynx/math/vector.hpp>
+#include <rynx/graphics/mesh/mesh.hpp>
+#include <rynx/graphics/texture/texturehandler.hpp>
+#include <rynx/graphics/renderer/meshrenderer.hpp>
+
+#include <game/strip_mesh_builder.hpp>
+#include <game/transform_changes.hpp>
+
+#include <string>
+#include <vector>
+
+namespace game {
+	struct terrain_streaming_config {
+		float track_begin = -1000.0f; // world x where the first chunk starts.
+		float chunk_width = 1000.0f;
+		float sample_spacing = 10.0f;
+		float bottom = -1000.0f; // world y of the flat bottom of every chunk.
+
+		// maximum vertical deviation allowed when dropping surface points. zero keeps every sample.
+		float render_tolerance = 0.5f;
+		float collision_tolerance = 0.5f;
+		
+		int32_t chunks_behind = 1; // chunks kept alive behind the camera.
+		int32_t chunks_ahead = 3; // chunks generated ahead of the camera.
+	};
+
+	// generates fixed width terrain chunks around the camera. chunks that fall out of
+	// the window are recycled for new chunks, so the amount of terrain entities, meshes
+	// and collision tree entries stays bounded regardless of track length.
+	class terrain_streaming : public rynx::application::logic::iruleset {
+	public:
+		terrain_streaming(
+			rynx::graphics::mesh_collection& meshes,
+			rynx::graphics::GPUTextures& textures,
+			std::string terrainTexture,
+			rynx::collision_detection::category_id terrainCollisionCategory,
+			terrain_streaming_config config = {});
+
+		// collision only terrain, for running the simulation without a renderer.
+		// builds with GAME_HEADLESS defined leave out the mesh code entirely and only support this one.
+		terrain_streaming(
+			rynx::collision_detection::category_id terrainCollisionCategory,
+			terrain_streaming_config config = {});
+
+		virtual ~terrain_streaming() = default;
+		virtual void onFrameProcess(rynx::scheduler::context& context, float dt) override;
+
+		// logic ticks run while the renderer still draws its prepared snapshot, so recycled chunk meshes are
+		// not refilled during the tick. call this on the gpu thread after the frame has been submitted.
+		void upload_meshes();
+
+	private:
+		struct chunk {
+			rynx::ecs::id entity;
+			std::vector<rynx::ecs::id> render_parts;
+			std::vector<rynx::graphics::mesh*> meshes;
+			int64_t index = -1; // -1 means the chunk is free for reuse.
+			bool created = false;
+		};
+
+		struct pending_upload {
+			rynx::graphics::mesh* mesh;
+			game::strip_mesh_builder::part part;
+		};
+
+		void load_chunk(rynx::ecs& ecs, rynx::collision_detection& detection, const game::transform_changes& changes, chunk& c, int64_t index);
+
+		rynx::graphics::mesh_collection* m_meshes = nullptr;
+		rynx::graphics::GPUTextures* m_textures = nullptr;
+		std::string m_texture;
+		rynx::collision_detection::category_id m_collision_category;
+		terrain_streaming_config m_config;
+		game::strip_mesh_builder m_mesh_builder;
+
+		std::vector<chunk> m_chunks;
+		std::vector<pending_upload> m_pending_uploads; // in recycle order, a later upload to the same mesh wins.
+		int64_t m_window_begin = -1;
+		int64_t m_window_end = -1;
+	};
+}
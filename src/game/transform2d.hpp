@@ -0,0 +1,78 @@
+#pragma once
+
+#include <rynx/math/vector.hpp>
+#include <rynx/tech/components.hpp>
+
+#include <cmath>
+
+namespace game {
+	// planar transform pack for the game's own hot loops. the simulation never moves anything along z, but the
+	// engine's position and motion components carry vec3s and rynx::matrix4 is a full 4x4. loops that stream
+	// transforms gather these instead, and write back to the engine components once when they are done.
+	struct vec2 {
+		float x = 0.0f;
+		float y = 0.0f;
+
+		constexpr vec2() = default;
+		constexpr vec2(float x_, float y_) : x(x_), y(y_) {}
+		explicit constexpr vec2(const rynx::vec3f& v) : x(v.x), y(v.y) {}
+
+		rynx::vec3f xyz(float z = 0.0f) const { return rynx::vec3f(x, y, z); }
+
+		constexpr vec2 operator+(vec2 o) const { return { x + o.x, y + o.y }; }
+		constexpr vec2 operator-(vec2 o) const { return { x - o.x, y - o.y }; }
+		constexpr vec2 operator*(float s) const { return { x * s, y * s }; }
+		constexpr vec2 operator-() const { return { -x, -y }; }
+		constexpr vec2& operator+=(vec2 o) { x += o.x; y += o.y; return *this; }
+		constexpr vec2& operator-=(vec2 o) { x -= o.x; y -= o.y; return *this; }
+		constexpr bool operator==(const vec2&) const = default;
+
+		constexpr float dot(vec2 o) const { return x * o.x + y * o.y; }
+		constexpr float cross(vec2 o) const { return x * o.y - y * o.x; }
+		constexpr float length_squared() const { return dot(*this); }
+	};
+
+	// where a body is. 12 bytes, against 16 or more for rynx::components::position.
+	struct pose2d {
+		vec2 position;
+		float angle = 0.0f;
+
+		static pose2d from(const rynx::components::position& pos) { return { vec2(pos.value), pos.angle }; }
+		constexpr bool operator==(const pose2d&) const = default;
+	};
+
+	// how a body moves. 12 bytes, against the velocity and acceleration vec3s of rynx::components::motion.
+	struct velocity2d {
+		vec2 linear;
+		float angular = 0.0f;
+
+		static velocity2d from(const rynx::components::motion& mot) { return { vec2(mot.velocity), mot.angularVelocity }; }
+
+		// velocity of a point at offset r from the body center.
+		constexpr vec2 at(vec2 r) const { return linear + vec2(-angular * r.y, angular * r.x); }
+	};
+
+	// a pose as a 2x3 matrix: rotation columns and translation, 24 bytes against 64 for rynx::matrix4.
+	// built once per body, so points attached to the body are placed without a sin and cos per point.
+	struct affine2d {
+		vec2 x_axis;
+		vec2 y_axis;
+		vec2 translation;
+
+		static affine2d from(const pose2d& pose, float sin_angle, float cos_angle) {
+			return { vec2(cos_angle, sin_angle), vec2(-sin_angle, cos_angle), pose.position };
+		}
+
+		static affine2d from(const pose2d& pose) {
+			return from(pose, std::sin(pose.angle), std::cos(pose.angle));
+		}
+
+		constexpr vec2 rotate(vec2 v) const { return x_axis * v.x + y_axis * v.y; }
+		constexpr vec2 transform(vec2 v) const { return rotate(v) + translation; }
+	};
+
+	static_assert(sizeof(vec2) == 8);
+	static_assert(sizeof(pose2d) == 12);
+	static_assert(sizeof(velocity2d) == 12);
+	static_assert(sizeof(affine2d) == 24);
+}
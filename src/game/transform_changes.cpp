@@ -0,0 +1,63 @@
+#include <game/transform_changes.hpp>
+
+#include <rynx/tech/components.hpp>
+#include <rynx/tech/profiling.hpp>
+
+void game::transform_changes::observe(rynx::ecs::id id, pose now) {
+	auto [it, inserted] = m_records.try_emplace(id.value);
+	record& r = it->second;
+	r.seen = m_tick;
+
+	if (inserted) {
+		r.last = now;
+		r.changed = m_tick;
+		m_history[m_tick % history_length].emplace_back(id);
+		return;
+	}
+
+	if (r.last == now) {
+		return;
+	}
+
+	m_last_tick.emplace_back(change{ id, r.last, now });
+	m_history[m_tick % history_length].emplace_back(id);
+	r.last = now;
+	r.changed = m_tick;
+}
+
+void game::transform_changes::end_tick(rynx::ecs& ecs) {
+	rynx_profile("Game", "transform changes");
+
+	++m_tick;
+	m_last_tick.clear();
+	m_history[m_tick % history_length].clear();
+	m_marked_history[m_tick % history_length].clear();
+
+	ecs.query().for_each([this](rynx::ecs::id id, const rynx::components::position& pos, const rynx::components::motion&) {
+		observe(id, pose::from(pos));
+	});
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_pending_marks.swap(m_marks);
+	}
+
+	for (rynx::ecs::id id : m_pending_marks) {
+		m_marked_history[m_tick % history_length].emplace_back(id);
+		if (!ecs.exists(id)) {
+			continue;
+		}
+
+		// observing an entity twice in a tick finds it unchanged the second time.
+		const auto* pos = ecs[id].try_get<rynx::components::position>();
+		if (pos) {
+			observe(id, pose::from(*pos));
+		}
+	}
+	m_pending_marks.clear();
+
+	// records of erased entities, and of marked ones that have stopped moving, are dropped once they fall out of the history.
+	if (m_tick % history_length == 0) {
+		std::erase_if(m_records, [this](const auto& entry) { return m_tick - entry.second.seen > history_length; });
+	}
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <game/transform2d.hpp>
+#include <rynx/tech/ecs.hpp>
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace game {
+	// which entities moved in which logic tick, so that per tick work can follow the bodies that move instead of
+	// the size of the world. rynx's motion integrator and collision response move entities that have a motion
+	// component and do not report what they touched, so end_tick() compares that table against the poses seen
+	// the tick before. static geometry has no motion component and is never visited. code that moves it anyway
+	// (editor drags, recycled terrain chunks, replay ghosts) calls mark() instead.
+	//
+	// entities created during a tick are reported as changed once, with no earlier pose.
+	// game::ecs_commands marks the entities it creates and erases, so static geometry that comes and goes is seen too.
+	class transform_changes {
+	public:
+		// the simulation is planar, z is not tracked.
+		using pose = game::pose2d;
+
+		struct change {
+			rynx::ecs::id id;
+			pose before;
+			pose after;
+		};
+
+		// moves and other edits of entities without a motion component. callable from tasks.
+		void mark(rynx::ecs::id id) const {
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_marks.emplace_back(id);
+		}
+
+		// once per logic tick, after tasks and ecs commands have completed.
+		void end_tick(rynx::ecs& ecs);
+
+		// number of the last completed tick. tick 0 is before the first one.
+		uint64_t tick() const { return m_tick; }
+
+		// tick in which the entity last moved, 0 if it has not moved lately.
+		uint64_t changed_tick(rynx::ecs::id id) const {
+			auto it = m_records.find(id.value);
+			return (it != m_records.end()) ? it->second.changed : 0;
+		}
+
+		// entities that moved in the last tick, with their pose before and after it. created entities are not included.
+		const std::vector<change>& last_tick() const { return m_last_tick; }
+
+		// calls op(id) for each entity that moved after tick `since`, once for every tick it moved in.
+		// returns false without calling op when `since` is older than the kept history,
+		// the caller has to treat everything as changed then.
+		template<typename F>
+		bool for_each_changed_since(uint64_t since, F&& op) const {
+			return for_each_since(m_history, since, std::forward<F>(op));
+		}
+
+		// same, for marked entities only, whether their pose changed or not. includes marked entities that
+		// have since been erased. static geometry only changes through marks, so this is all of its changes
+		// without visiting the bodies that move every tick.
+		template<typename F>
+		bool for_each_marked_since(uint64_t since, F&& op) const {
+			return for_each_since(m_marked_history, since, std::forward<F>(op));
+		}
+
+	private:
+		static constexpr uint64_t history_length = 64;
+		using history = std::array<std::vector<rynx::ecs::id>, history_length>;
+
+		template<typename F>
+		bool for_each_since(const history& ticks, uint64_t since, F&& op) const {
+			if (m_tick > since && m_tick - since > history_length) {
+				return false;
+			}
+			for (uint64_t tick = since + 1; tick <= m_tick; ++tick) {
+				for (rynx::ecs::id id : ticks[tick % history_length]) {
+					op(id);
+				}
+			}
+			return true;
+		}
+
+		struct record {
+			pose last;
+			uint64_t changed = 0;
+			uint64_t seen = 0;
+		};
+
+		void observe(rynx::ecs::id id, pose now);
+
+		mutable std::mutex m_mutex;
+		mutable std::vector<rynx::ecs::id> m_marks;
+
+		std::unordered_map<uint64_t, record> m_records;
+		std::vector<change> m_last_tick;
+		history m_history;
+		history m_marked_history;
+		std::vector<rynx::ecs::id> m_pending_marks; // reused between ticks.
+		uint64_t m_tick = 0;
+	};
+}
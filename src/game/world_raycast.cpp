@@ -0,0 +1,351 @@
+
+#include <game/world_raycast.hpp>
+
+#include <rynx/scheduler/task.hpp>
+#include <rynx/tech/components.hpp>
+#include <rynx/tech/profiling.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <tuple>
+
+namespace {
+	struct cast_result {
+		float t;
+		float nx, ny;
+	};
+
+	float cross2d(float ax, float ay, float bx, float by) {
+		return ax * by - ay * bx;
+	}
+
+	// first t in [0, t_max] where p + d * t is within radius of c. a ray starting inside hits at t = 0.
+	bool ray_vs_circle(float px, float py, float dx, float dy, float cx, float cy, float radius, float t_max, cast_result& out) {
+		if (radius <= 0.0f) {
+			return false;
+		}
+
+		const float fx = px - cx;
+		const float fy = py - cy;
+		const float c = fx * fx + fy * fy - radius * radius;
+		if (c <= 0.0f) {
+			const float length = std::sqrt(fx * fx + fy * fy);
+			const float d_length = std::sqrt(dx * dx + dy * dy);
+			if (length > 1e-6f) {
+				out = { 0.0f, fx / length, fy / length };
+			}
+			else if (d_length > 0.0f) {
+				out = { 0.0f, -dx / d_length, -dy / d_length };
+			}
+			else {
+				out = { 0.0f, 0.0f, 1.0f };
+			}
+			return true;
+		}
+
+		const float a = dx * dx + dy * dy;
+		const float b = fx * dx + fy * dy;
+		if (a <= 0.0f || b >= 0.0f) {
+			return false;
+		}
+
+		const float discriminant = b * b - a * c;
+		if (discriminant < 0.0f) {
+			return false;
+		}
+
+		const float t = (-b - std::sqrt(discriminant)) / a;
+		if (t > t_max) {
+			return false;
+		}
+
+		out = { t, (fx + dx * t) / radius, (fy + dy * t) / radius };
+		return true;
+	}
+
+	// first t in [0, t_max] where p + d * t is within radius of the segment a -> b.
+	bool ray_vs_capsule(float px, float py, float dx, float dy, float ax, float ay, float bx, float by, float radius, float t_max, cast_result& out) {
+		const float ex = bx - ax;
+		const float ey = by - ay;
+		const float length_sqr = ex * ex + ey * ey;
+		if (length_sqr < 1e-12f) {
+			return ray_vs_circle(px, py, dx, dy, ax, ay, radius, t_max, out);
+		}
+
+		const float inv_length = 1.0f / std::sqrt(length_sqr);
+		const float nx = -ey * inv_length;
+		const float ny = ex * inv_length;
+		const float denominator = cross2d(dx, dy, ex, ey);
+
+		// crossing a line parallel to the segment at offset, within the segment span.
+		auto cross_line = [&](float ox, float oy, float& t) {
+			if (std::abs(denominator) < 1e-12f) {
+				return false;
+			}
+			const float wx = ox - px;
+			const float wy = oy - py;
+			t = cross2d(wx, wy, ex, ey) / denominator;
+			const float s = cross2d(wx, wy, dx, dy) / denominator;
+			return t >= 0.0f && t <= t_max && s >= 0.0f && s <= 1.0f;
+		};
+
+		if (radius <= 0.0f) {
+			float t;
+			if (!cross_line(ax, ay, t)) {
+				return false;
+			}
+			const float side = (dx * nx + dy * ny > 0.0f) ? -1.0f : 1.0f;
+			out = { t, nx * side, ny * side };
+			return true;
+		}
+
+		// starting inside.
+		const float s0 = std::clamp(((px - ax) * ex + (py - ay) * ey) / length_sqr, 0.0f, 1.0f);
+		const float qx = px - (ax + ex * s0);
+		const float qy = py - (ay + ey * s0);
+		const float q_sqr = qx * qx + qy * qy;
+		if (q_sqr < radius * radius) {
+			const float q = std::sqrt(q_sqr);
+			const float side = (qx * nx + qy * ny < 0.0f) ? -1.0f : 1.0f;
+			out = (q > 1e-6f) ? cast_result{ 0.0f, qx / q, qy / q } : cast_result{ 0.0f, nx * side, ny * side };
+			return true;
+		}
+
+		bool found = false;
+		for (float side : { 1.0f, -1.0f }) {
+			const float snx = nx * side;
+			const float sny = ny * side;
+			if (dx * snx + dy * sny >= 0.0f) {
+				continue;
+			}
+
+			float t;
+			if (cross_line(ax + snx * radius, ay + sny * radius, t) && (!found || t < out.t)) {
+				out = { t, snx, sny };
+				found = true;
+			}
+		}
+
+		cast_result end;
+		if (ray_vs_circle(px, py, dx, dy, ax, ay, radius, t_max, end) && (!found || end.t < out.t)) {
+			out = end;
+			found = true;
+		}
+		if (ray_vs_circle(px, py, dx, dy, bx, by, radius, t_max, end) && (!found || end.t < out.t)) {
+			out = end;
+			found = true;
+		}
+		return found;
+	}
+}
+
+void game::world_raycast::build(rynx::ecs& ecs, const std::vector<rynx::collision_detection::category_id>& categories, float max_cast_radius) {
+	rynx_profile("Game", "build world raycast");
+	m_shapes.clear();
+	m_cell_begin.clear();
+	m_cell_shapes.clear();
+	m_max_cast_radius = std::max(max_cast_radius, 0.0f);
+	m_columns = 0;
+	m_rows = 0;
+
+	auto wanted = [&](const rynx::components::collisions& collisions) {
+		return std::any_of(categories.begin(), categories.end(), [&](rynx::collision_detection::category_id category) {
+			return collisions.category == category.value;
+		});
+	};
+
+	ecs.query().notIn<rynx::components::boundary>().for_each([&](rynx::ecs::id id, const rynx::components::collisions& collisions, const rynx::components::position& pos, const rynx::components::radius& radius) {
+		if (wanted(collisions)) {
+			m_shapes.emplace_back(capsule{ pos.value.x, pos.value.y, pos.value.x, pos.value.y, radius.r, id.value });
+		}
+	});
+
+	ecs.query().for_each([&](rynx::ecs::id id, const rynx::components::collisions& collisions, const rynx::components::boundary& boundary) {
+		if (wanted(collisions)) {
+			for (int32_t i = 0; i < boundary.segments_world.size(); ++i) {
+				const auto s = boundary.segments_world.segment(i);
+				m_shapes.emplace_back(capsule{ s.p1.x, s.p1.y, s.p2.x, s.p2.y, 0.0f, id.value });
+			}
+		}
+	});
+
+	build_grid();
+}
+
+void game::world_raycast::build_grid() {
+	const int32_t count = static_cast<int32_t>(m_shapes.size());
+	if (count == 0) {
+		return;
+	}
+
+	// shapes are registered in every cell that a cast can be in while touching them, so bounds grow by the cast radius.
+	auto bounds = [this](const capsule& c) {
+		const float margin = c.radius + m_max_cast_radius;
+		return std::make_tuple(
+			std::min(c.ax, c.bx) - margin, std::min(c.ay, c.by) - margin,
+			std::max(c.ax, c.bx) + margin, std::max(c.ay, c.by) + margin);
+	};
+
+	float min_x = std::numeric_limits<float>::max(), min_y = std::numeric_limits<float>::max();
+	float max_x = std::numeric_limits<float>::lowest(), max_y = std::numeric_limits<float>::lowest();
+	float total_extent = 0.0f;
+	for (const auto& shape : m_shapes) {
+		auto [x0, y0, x1, y1] = bounds(shape);
+		min_x = std::min(min_x, x0);
+		min_y = std::min(min_y, y0);
+		max_x = std::max(max_x, x1);
+		max_y = std::max(max_y, y1);
+		total_extent += std::max(x1 - x0, y1 - y0);
+	}
+
+	// cells around shape size, but no more cells than shapes.
+	const float width = std::max(max_x - min_x, 1e-3f);
+	const float height = std::max(max_y - min_y, 1e-3f);
+	m_cell_size = std::max({ total_extent / count, std::sqrt(width * height / count), 1e-3f });
+	m_min_x = min_x;
+	m_min_y = min_y;
+	m_columns = std::max(1, static_cast<int32_t>(std::ceil(width / m_cell_size)));
+	m_rows = std::max(1, static_cast<int32_t>(std::ceil(height / m_cell_size)));
+
+	// counting pass, then fill. cells store shapes in index order.
+	auto for_each_cell = [&](int32_t i, auto&& op) {
+		auto [x0, y0, x1, y1] = bounds(m_shapes[i]);
+		const int32_t cx0 = cell_x(x0);
+		const int32_t cx1 = cell_x(x1);
+		const int32_t cy0 = cell_y(y0);
+		const int32_t cy1 = cell_y(y1);
+		for (int32_t y = cy0; y <= cy1; ++y) {
+			for (int32_t x = cx0; x <= cx1; ++x) {
+				op(y * m_columns + x);
+			}
+		}
+	};
+
+	m_cell_begin.assign(size_t(m_columns) * m_rows + 1, 0);
+	for (int32_t i = 0; i < count; ++i) {
+		for_each_cell(i, [this](int32_t cell) { ++m_cell_begin[cell + 1]; });
+	}
+
+	for (size_t cell = 1; cell < m_cell_begin.size(); ++cell) {
+		m_cell_begin[cell] += m_cell_begin[cell - 1];
+	}
+
+	std::vector<int32_t> cursor(m_cell_begin.begin(), m_cell_begin.end() - 1);
+	m_cell_shapes.resize(m_cell_begin.back());
+	for (int32_t i = 0; i < count; ++i) {
+		for_each_cell(i, [&](int32_t cell) { m_cell_shapes[cursor[cell]++] = i; });
+	}
+}
+
+int32_t game::world_raycast::cell_x(float x) const {
+	return std::clamp(static_cast<int32_t>(std::floor((x - m_min_x) / m_cell_size)), 0, m_columns - 1);
+}
+
+int32_t game::world_raycast::cell_y(float y) const {
+	return std::clamp(static_cast<int32_t>(std::floor((y - m_min_y) / m_cell_size)), 0, m_rows - 1);
+}
+
+game::ray_hit game::world_raycast::cast(const ray_query& query) const {
+	ray_hit result;
+	if (empty()) {
+		return result;
+	}
+
+	const float radius = std::clamp(query.radius, 0.0f, m_max_cast_radius);
+	const float px = query.from.x;
+	const float py = query.from.y;
+	const float dx = query.to.x - px;
+	const float dy = query.to.y - py;
+
+	// clip the cast to the grid. nothing outside of it can be hit.
+	float t_enter = 0.0f;
+	float t_exit = 1.0f;
+	auto clip = [&](float p, float d, float lo, float hi) {
+		if (std::abs(d) < 1e-12f) {
+			return p >= lo && p <= hi;
+		}
+		float ta = (lo - p) / d;
+		float tb = (hi - p) / d;
+		if (ta > tb) {
+			std::swap(ta, tb);
+		}
+		t_enter = std::max(t_enter, ta);
+		t_exit = std::min(t_exit, tb);
+		return t_enter <= t_exit;
+	};
+
+	if (!clip(px, dx, m_min_x, m_min_x + m_columns * m_cell_size) || !clip(py, dy, m_min_y, m_min_y + m_rows * m_cell_size)) {
+		return result;
+	}
+
+	constexpr float never = std::numeric_limits<float>::max();
+	int32_t cx = cell_x(px + dx * t_enter);
+	int32_t cy = cell_y(py + dy * t_enter);
+	const int32_t step_x = (dx > 0.0f) ? 1 : -1;
+	const int32_t step_y = (dy > 0.0f) ? 1 : -1;
+	const float t_delta_x = (dx != 0.0f) ? m_cell_size / std::abs(dx) : never;
+	const float t_delta_y = (dy != 0.0f) ? m_cell_size / std::abs(dy) : never;
+	float t_next_x = (dx != 0.0f) ? (m_min_x + (cx + (dx > 0.0f ? 1 : 0)) * m_cell_size - px) / dx : never;
+	float t_next_y = (dy != 0.0f) ? (m_min_y + (cy + (dy > 0.0f ? 1 : 0)) * m_cell_size - py) / dy : never;
+
+	cast_result best{ 1.0f, 0.0f, 0.0f };
+	int32_t best_shape = -1;
+	for (;;) {
+		const int32_t cell = cy * m_columns + cx;
+		for (int32_t k = m_cell_begin[cell]; k < m_cell_begin[cell + 1]; ++k) {
+			const int32_t index = m_cell_shapes[k];
+			const auto& shape = m_shapes[index];
+			cast_result candidate;
+			if (ray_vs_capsule(px, py, dx, dy, shape.ax, shape.ay, shape.bx, shape.by, shape.radius + radius, best.t, candidate)) {
+				// a shape listed in several cells gives the same result each time, the lower index wins ties.
+				if (best_shape == -1 || candidate.t < best.t || (candidate.t == best.t && index < best_shape)) {
+					best = candidate;
+					best_shape = index;
+				}
+			}
+		}
+
+		// everything in the cells further along is hit later than this cell's exit.
+		const float cell_exit = std::min(t_next_x, t_next_y);
+		if ((best_shape != -1 && best.t <= cell_exit) || cell_exit > t_exit) {
+			break;
+		}
+
+		if (t_next_x < t_next_y) {
+			cx += step_x;
+			t_next_x += t_delta_x;
+		}
+		else {
+			cy += step_y;
+			t_next_y += t_delta_y;
+		}
+
+		if (cx < 0 || cx >= m_columns || cy < 0 || cy >= m_rows) {
+			break;
+		}
+	}
+
+	if (best_shape != -1) {
+		result.id = m_shapes[best_shape].id;
+		result.hit = true;
+		result.t = best.t;
+		result.normal = rynx::vec3f(best.nx, best.ny, 0.0f);
+		result.point = rynx::vec3f(px + dx * best.t - best.nx * radius, py + dy * best.t - best.ny * radius, 0.0f);
+	}
+	return result;
+}
+
+void game::world_raycast::cast(const ray_query* queries, int32_t count, ray_hit* hits) const {
+	rynx_profile("Game", "world raycast");
+	for (int32_t i = 0; i < count; ++i) {
+		hits[i] = cast(queries[i]);
+	}
+}
+
+void game::world_raycast::cast(rynx::scheduler::task& task_context, const ray_query* queries, int32_t count, ray_hit* hits) const {
+	rynx_profile("Game", "world raycast");
+	task_context.parallel().for_each(0, count, [this, queries, hits](int64_t i) {
+		hits[i] = cast(queries[i]);
+	}, 256);
+}
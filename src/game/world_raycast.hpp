@@ -0,0 +1,74 @@
+#pragma once
+
+#include <rynx/tech/ecs.hpp>
+#include <rynx/tech/collision_detection.hpp>
+#include <rynx/math/vector.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace rynx {
+	namespace scheduler {
+		class task;
+	}
+}
+
+namespace game {
+	// segment from `from` to `to`, swept with a circle of radius. zero radius is a plain ray cast.
+	struct ray_query {
+		rynx::vec3f from;
+		rynx::vec3f to;
+		float radius = 0.0f;
+	};
+
+	struct ray_hit {
+		rynx::ecs::id id;
+		bool hit = false;
+		float t = 1.0f; // fraction of from -> to travelled before the hit.
+		rynx::vec3f point; // on the surface of the shape that was hit.
+		rynx::vec3f normal; // surface normal at point, facing the query.
+	};
+
+	// snapshot of the collision shapes of some categories, for casting large batches of rays against the world:
+	// hitscan weapons, line of sight checks and editor picking.
+	// circle bodies and every segment of every boundary are stored as capsules in a uniform grid, which is built
+	// once per snapshot. each ray then walks the grid cells along its path and stops at the first cell that
+	// ends behind the closest hit so far.
+	class world_raycast {
+	public:
+		// max_cast_radius is the largest radius any later shape cast will use. larger radii are clamped to it.
+		void build(rynx::ecs& ecs, const std::vector<rynx::collision_detection::category_id>& categories, float max_cast_radius = 0.0f);
+
+		// first hit of every query. hits must have room for count results.
+		void cast(const ray_query* queries, int32_t count, ray_hit* hits) const;
+
+		// same, with the queries split across the scheduler workers.
+		void cast(rynx::scheduler::task& task_context, const ray_query* queries, int32_t count, ray_hit* hits) const;
+
+		ray_hit cast(const ray_query& query) const;
+
+		bool empty() const { return m_shapes.empty(); }
+
+	private:
+		// circles have a == b.
+		struct capsule {
+			float ax, ay, bx, by;
+			float radius;
+			uint64_t id;
+		};
+
+		void build_grid();
+		int32_t cell_x(float x) const;
+		int32_t cell_y(float y) const;
+
+		std::vector<capsule> m_shapes;
+		std::vector<int32_t> m_cell_begin; // m_columns * m_rows + 1 offsets into m_cell_shapes.
+		std::vector<int32_t> m_cell_shapes;
+		float m_min_x = 0.0f;
+		float m_min_y = 0.0f;
+		float m_cell_size = 1.0f;
+		float m_max_cast_radius = 0.0f;
+		int32_t m_columns = 0;
+		int32_t m_rows = 0;
+	};
+}